@@ -3,6 +3,7 @@
 #include <c++utilities/misc/parseerror.h>
 #include <c++utilities/conversion/stringconversion.h>
 
+#include <charconv>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -32,30 +33,30 @@ Angle::Angle(double value, AngularMeasure measure)
     }
 }
 
-Angle::Angle(const string &value, AngularMeasure measure)
+Angle::Angle(string_view value, AngularMeasure measure)
     : m_val(0)
 {
     switch (measure) {
     case AngularMeasure::Radian:
-        m_val += stringToNumber<double>(value);
+        m_val += numberFromString(value);
         break;
     case AngularMeasure::Degree: {
-        string::size_type mpos, spos = string::npos;
+        string_view::size_type mpos, spos = string_view::npos;
         mpos = value.find(':');
-        if (mpos == string::npos)
-            m_val += stringToNumber<double>(value);
+        if (mpos == string_view::npos)
+            m_val += numberFromString(value);
         else if (mpos >= (value.length() - 1))
-            throw ParseError("excepted minutes after ':' in " + value);
+            throw ParseError("excepted minutes after ':' in " + string(value));
         else {
-            m_val += stringToNumber<double>(value.substr(0, mpos));
+            m_val += numberFromString(value.substr(0, mpos));
             spos = value.find(':', mpos + 1);
-            if (spos == string::npos)
-                m_val += stringToNumber<double>(value.substr(mpos + 1)) / 60.0;
+            if (spos == string_view::npos)
+                m_val += numberFromString(value.substr(mpos + 1)) / 60.0;
             else if (spos >= (value.length() - 1))
-                throw ParseError("excepted seconds after second ':'' in " + value);
+                throw ParseError("excepted seconds after second ':'' in " + string(value));
             else
-                m_val += (stringToNumber<double>(value.substr(mpos + 1, spos - mpos - 1)) / 60.0)
-                    + (stringToNumber<double>(value.substr(spos + 1)) / 3600.0);
+                m_val += (numberFromString(value.substr(mpos + 1, spos - mpos - 1)) / 60.0)
+                    + (numberFromString(value.substr(spos + 1)) / 3600.0);
         }
         m_val = m_val * M_PI / 180.0;
         break;
@@ -163,3 +164,22 @@ Angle &Angle::operator-=(const Angle &other)
     m_val -= other.m_val;
     return *this;
 }
+
+// parses a decimal number like stringToNumber<double>() (accepting leading white space and a plus sign) but without allocating
+double numberFromString(string_view value)
+{
+    const auto begin = value.find_first_not_of(" \t\n\v\f\r");
+    if (begin != string_view::npos) {
+        value.remove_prefix(begin);
+        if (value.size() > 1 && value.front() == '+' && value[1] != '-') {
+            value.remove_prefix(1);
+        }
+        double number;
+        const char *const end = value.data() + value.size();
+        const auto result = from_chars(value.data(), end, number);
+        if (result.ec == errc() && result.ptr == end && isfinite(number)) {
+            return number;
+        }
+    }
+    throw ConversionException("The string \"" + string(value) + "\" is no valid number.");
+}
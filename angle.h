@@ -2,6 +2,7 @@
 #define COORDINATE_H
 
 #include <string>
+#include <string_view>
 
 class Angle {
 public:
@@ -11,7 +12,7 @@ public:
 
     Angle();
     Angle(double value, AngularMeasure measure = AngularMeasure::Radian);
-    explicit Angle(const std::string &value, AngularMeasure measure = AngularMeasure::Radian);
+    explicit Angle(std::string_view value, AngularMeasure measure = AngularMeasure::Radian);
     double degreeValue() const;
     double radianValue() const;
     bool isNull() const;
@@ -32,4 +33,6 @@ private:
     double m_val;
 };
 
+double numberFromString(std::string_view value);
+
 #endif // COORDINATE_H
@@ -0,0 +1,232 @@
+#include "./clustering.h"
+#include "./parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265359
+#endif
+
+using namespace std;
+
+namespace {
+
+struct Point {
+    double x, y, z;
+};
+
+// 64-bit coordinates so even cells of a micrometer do not overflow at the scale of the earth
+struct Cell {
+    int64_t x, y, z;
+    bool operator==(const Cell &other) const
+    {
+        return x == other.x && y == other.y && z == other.z;
+    }
+    bool operator<(const Cell &other) const
+    {
+        return x != other.x ? x < other.x : (y != other.y ? y < other.y : z < other.z);
+    }
+};
+
+struct CellHash {
+    size_t operator()(const Cell &cell) const
+    {
+        uint64_t hash = static_cast<uint64_t>(cell.x);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(cell.y);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(cell.z);
+        return static_cast<size_t>(hash ^ (hash >> 29));
+    }
+};
+
+size_t findRoot(vector<atomic<size_t>> &parents, size_t index)
+{
+    for (size_t parent; (parent = parents[index].load(memory_order_relaxed)) != index;) {
+        // path halving; losing the race against another thread is harmless
+        const size_t grandParent = parents[parent].load(memory_order_relaxed);
+        parents[index].compare_exchange_weak(parent, grandParent, memory_order_relaxed);
+        index = grandParent;
+    }
+    return index;
+}
+
+// unites the sets of a and b; roots are always linked to the smaller index so concurrent calls need only a compare-and-swap
+void unite(vector<atomic<size_t>> &parents, size_t a, size_t b)
+{
+    for (;;) {
+        a = findRoot(parents, a);
+        b = findRoot(parents, b);
+        if (a == b) {
+            return;
+        }
+        if (a < b) {
+            swap(a, b);
+        }
+        size_t expected = a;
+        if (parents[a].compare_exchange_strong(expected, b, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+} // namespace
+
+vector<int64_t> dbscan(const LocationStorage &locations, double eps, size_t minPoints)
+{
+    const size_t size = locations.size();
+
+    // work with cartesian coordinates; the chord length is monotonic in the great-circle distance so comparing squared chord
+    // lengths is equivalent to comparing distances but avoids trigonometric functions
+    const double radius = Location::earthRadius();
+    const double maxChord = 2.0 * radius * sin(min(eps / (2.0 * radius), M_PI / 2.0));
+    const double maxChordSquared = maxChord * maxChord;
+    // the diagonal of a cell is eps so all points within a cell are neighbors and neighbors are at most two cells away
+    const double cellSize = maxChord / sqrt(3.0);
+    vector<Point> points(size);
+    vector<Cell> cellOfPoint(size);
+    parallelForChunks(size, 4096, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i != end; ++i) {
+            const double lat = locations[i].latitude().radianValue(), lon = locations[i].longitude().radianValue();
+            Point &point = points[i];
+            point = Point{ radius * cos(lat) * cos(lon), radius * cos(lat) * sin(lon), radius * sin(lat) };
+            cellOfPoint[i] = Cell{ static_cast<int64_t>(floor(point.x / cellSize)), static_cast<int64_t>(floor(point.y / cellSize)),
+                static_cast<int64_t>(floor(point.z / cellSize)) };
+        }
+    });
+
+    // group the points by cell so the points of a cell are contiguous
+    vector<size_t> order(size);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(),
+        [&cellOfPoint](size_t a, size_t b) { return cellOfPoint[a] < cellOfPoint[b] || (cellOfPoint[a] == cellOfPoint[b] && a < b); });
+    vector<pair<size_t, size_t>> cellRanges;
+    unordered_map<Cell, size_t, CellHash> cellIndices;
+    for (size_t i = 0; i != size;) {
+        const Cell &cell = cellOfPoint[order[i]];
+        const size_t begin = i;
+        for (; i != size && cellOfPoint[order[i]] == cell; ++i)
+            ;
+        cellIndices.emplace(cell, cellRanges.size());
+        cellRanges.emplace_back(begin, i);
+    }
+    const auto forEachNeighborCell = [&](size_t cellIndex, const auto &callback) {
+        const Cell &cell = cellOfPoint[order[cellRanges[cellIndex].first]];
+        for (int64_t dx = -2; dx <= 2; ++dx) {
+            for (int64_t dy = -2; dy <= 2; ++dy) {
+                for (int64_t dz = -2; dz <= 2; ++dz) {
+                    const auto neighbor = cellIndices.find(Cell{ cell.x + dx, cell.y + dy, cell.z + dz });
+                    if (neighbor != cellIndices.end() && !callback(neighbor->second)) {
+                        return;
+                    }
+                }
+            }
+        }
+    };
+    const auto areNeighbors = [&](size_t a, size_t b) {
+        const double x = points[a].x - points[b].x, y = points[a].y - points[b].y, z = points[a].z - points[b].z;
+        return x * x + y * y + z * z <= maxChordSquared;
+    };
+
+    // determine core points; cells with enough points consist only of core points
+    vector<char> core(size);
+    vector<size_t> firstCore(cellRanges.size(), size);
+    parallelForChunks(cellRanges.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t cellIndex = begin; cellIndex != end; ++cellIndex) {
+            const auto range = cellRanges[cellIndex];
+            for (size_t i = range.first; i != range.second; ++i) {
+                size_t count = range.second - range.first;
+                if (count < minPoints) {
+                    forEachNeighborCell(cellIndex, [&](size_t neighborCell) {
+                        if (neighborCell == cellIndex) {
+                            return true;
+                        }
+                        const auto neighborRange = cellRanges[neighborCell];
+                        for (size_t j = neighborRange.first; j != neighborRange.second && count < minPoints; ++j) {
+                            count += areNeighbors(order[i], order[j]);
+                        }
+                        return count < minPoints;
+                    });
+                }
+                if ((core[order[i]] = count >= minPoints) && firstCore[cellIndex] == size) {
+                    firstCore[cellIndex] = order[i];
+                }
+            }
+        }
+    });
+
+    // connect cells containing core points which are neighbors (all core points of a cell belong to the same cluster)
+    vector<atomic<size_t>> parents(size);
+    for (size_t i = 0; i != size; ++i) {
+        parents[i].store(i, memory_order_relaxed);
+    }
+    parallelForChunks(cellRanges.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t cellIndex = begin; cellIndex != end; ++cellIndex) {
+            if (firstCore[cellIndex] == size) {
+                continue;
+            }
+            const auto range = cellRanges[cellIndex];
+            forEachNeighborCell(cellIndex, [&](size_t neighborCell) {
+                if (neighborCell <= cellIndex || firstCore[neighborCell] == size
+                    || findRoot(parents, firstCore[cellIndex]) == findRoot(parents, firstCore[neighborCell])) {
+                    return true;
+                }
+                const auto neighborRange = cellRanges[neighborCell];
+                for (size_t i = range.first; i != range.second; ++i) {
+                    if (!core[order[i]]) {
+                        continue;
+                    }
+                    for (size_t j = neighborRange.first; j != neighborRange.second; ++j) {
+                        if (core[order[j]] && areNeighbors(order[i], order[j])) {
+                            unite(parents, firstCore[cellIndex], firstCore[neighborCell]);
+                            return true;
+                        }
+                    }
+                }
+                return true;
+            });
+        }
+    });
+
+    // attach border points to the cluster of the first neighboring core point found; use the first core point of its cell as
+    // only those were united above
+    vector<size_t> corePointOf(size, size);
+    parallelForChunks(cellRanges.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t cellIndex = begin; cellIndex != end; ++cellIndex) {
+            const auto range = cellRanges[cellIndex];
+            for (size_t i = range.first; i != range.second; ++i) {
+                const size_t point = order[i];
+                if (core[point] || firstCore[cellIndex] != size) {
+                    corePointOf[point] = firstCore[cellIndex];
+                    continue;
+                }
+                forEachNeighborCell(cellIndex, [&](size_t neighborCell) {
+                    if (firstCore[neighborCell] == size) {
+                        return true;
+                    }
+                    const auto neighborRange = cellRanges[neighborCell];
+                    for (size_t j = neighborRange.first; j != neighborRange.second; ++j) {
+                        if (core[order[j]] && areNeighbors(point, order[j])) {
+                            corePointOf[point] = firstCore[neighborCell];
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+            }
+        }
+    });
+
+    // number the clusters in the order they first appear in the input; noise is marked with -1
+    vector<int64_t> clusterIds(size, -1);
+    unordered_map<size_t, int64_t> idsByRoot;
+    for (size_t i = 0; i != size; ++i) {
+        if (corePointOf[i] != size) {
+            clusterIds[i] = idsByRoot.emplace(findRoot(parents, corePointOf[i]), static_cast<int64_t>(idsByRoot.size())).first->second;
+        }
+    }
+    return clusterIds;
+}
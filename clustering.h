@@ -0,0 +1,12 @@
+#ifndef CLUSTERING_H
+#define CLUSTERING_H
+
+#include "./locationstorage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+std::vector<std::int64_t> dbscan(const LocationStorage &locations, double eps, std::size_t minPoints);
+
+#endif // CLUSTERING_H
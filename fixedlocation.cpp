@@ -0,0 +1,66 @@
+#include "./fixedlocation.h"
+
+#include <c++utilities/misc/parseerror.h>
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace {
+
+int32_t unitsFromDegrees(double degrees, int64_t limit)
+{
+    const double units = round(degrees * FixedLocation::unitsPerDegree);
+    if (!(fabs(units) <= static_cast<double>(limit * FixedLocation::unitsPerDegree))) {
+        throw ParseError("Coordinate out of range.");
+    }
+    return static_cast<int32_t>(units);
+}
+
+Angle normalizedLongitude(const Location &location)
+{
+    Angle longitude(location.longitude());
+    longitude.adjust180To180();
+    return longitude;
+}
+
+void appendUnits(string &result, int32_t units)
+{
+    if (units < 0) {
+        result += '-';
+    }
+    const int64_t absUnits = llabs(static_cast<int64_t>(units));
+    result += to_string(absUnits / FixedLocation::unitsPerDegree);
+    auto fraction = to_string(absUnits % FixedLocation::unitsPerDegree + FixedLocation::unitsPerDegree).substr(1);
+    const auto lastDigit = fraction.find_last_not_of('0');
+    if (lastDigit != string::npos) {
+        result += '.';
+        result.append(fraction, 0, lastDigit + 1);
+    }
+}
+
+} // namespace
+
+FixedLocation::FixedLocation(const Location &location)
+    : m_lat(unitsFromDegrees(location.latitude().degreeValue(), 90))
+    , m_lon(unitsFromDegrees(normalizedLongitude(location).degreeValue(), 180))
+{
+}
+
+Location FixedLocation::toLocation() const
+{
+    return Location(Angle(static_cast<double>(m_lat) / unitsPerDegree, Angle::AngularMeasure::Degree),
+        Angle(static_cast<double>(m_lon) / unitsPerDegree, Angle::AngularMeasure::Degree));
+}
+
+string FixedLocation::toString() const
+{
+    string result;
+    result.reserve(24);
+    appendUnits(result, m_lat);
+    result += ',';
+    appendUnits(result, m_lon);
+    return result;
+}
@@ -0,0 +1,87 @@
+#ifndef FIXEDLOCATION_H
+#define FIXEDLOCATION_H
+
+#include "./location.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class FixedLocation {
+public:
+    static constexpr std::int32_t unitsPerDegree = 10000000;
+
+    FixedLocation();
+    FixedLocation(std::int32_t latitudeUnits, std::int32_t longitudeUnits);
+    explicit FixedLocation(const Location &location);
+
+    std::int32_t latitudeUnits() const;
+    std::int32_t longitudeUnits() const;
+    Location toLocation() const;
+    std::string toString() const;
+    std::uint64_t key() const;
+
+    bool operator==(const FixedLocation &other) const;
+    bool operator!=(const FixedLocation &other) const;
+    bool operator<(const FixedLocation &other) const;
+
+private:
+    std::int32_t m_lat;
+    std::int32_t m_lon;
+};
+
+inline FixedLocation::FixedLocation()
+    : m_lat(0)
+    , m_lon(0)
+{
+}
+
+inline FixedLocation::FixedLocation(std::int32_t latitudeUnits, std::int32_t longitudeUnits)
+    : m_lat(latitudeUnits)
+    , m_lon(longitudeUnits)
+{
+}
+
+inline std::int32_t FixedLocation::latitudeUnits() const
+{
+    return m_lat;
+}
+
+inline std::int32_t FixedLocation::longitudeUnits() const
+{
+    return m_lon;
+}
+
+inline std::uint64_t FixedLocation::key() const
+{
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(m_lat)) << 32) | static_cast<std::uint32_t>(m_lon);
+}
+
+inline bool FixedLocation::operator==(const FixedLocation &other) const
+{
+    return m_lat == other.m_lat && m_lon == other.m_lon;
+}
+
+inline bool FixedLocation::operator!=(const FixedLocation &other) const
+{
+    return !(*this == other);
+}
+
+inline bool FixedLocation::operator<(const FixedLocation &other) const
+{
+    return m_lat != other.m_lat ? m_lat < other.m_lat : m_lon < other.m_lon;
+}
+
+namespace std {
+template <> struct hash<FixedLocation> {
+    std::size_t operator()(const FixedLocation &location) const
+    {
+        // mix the bits as the coordinates of nearby locations only differ in the lower bits
+        std::uint64_t key = location.key() * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(key ^ (key >> 32));
+    }
+};
+} // namespace std
+
+#endif // FIXEDLOCATION_H
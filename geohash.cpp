@@ -0,0 +1,112 @@
+#include "./geohash.h"
+
+#include <c++utilities/misc/parseerror.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace CppUtilities;
+
+// A geohash interleaves the bits of the longitude and latitude (starting with the longitude) which are obtained by repeatedly bisecting
+// the coordinate ranges. This is equivalent to interleaving the coordinates scaled to 32 bit integers so the most significant 5 bits
+// of the interleaved value correspond to the first character of the geohash and so on.
+#define GEOHASH_MAX_PRECISION 12
+
+namespace {
+
+const char geohashAlphabet[] = "0123456789bcdefghjkmnpqrstuvwxyz";
+
+inline uint64_t spreadBits(uint32_t value)
+{
+#if defined(__BMI2__)
+    return _pdep_u64(value, 0x5555555555555555ull);
+#else
+    uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+#endif
+}
+
+inline uint32_t compactBits(uint64_t value)
+{
+#if defined(__BMI2__)
+    return static_cast<uint32_t>(_pext_u64(value, 0x5555555555555555ull));
+#else
+    uint64_t x = value & 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+    return static_cast<uint32_t>(x);
+#endif
+}
+
+inline uint32_t scaleCoordinate(double value, double min, double range)
+{
+    // clamp in floating point so the conversion is well-defined for any input
+    const double scaled = (value - min) * (4294967296.0 / range);
+    return static_cast<uint32_t>(std::min(std::max(scaled, 0.0), 4294967295.0));
+}
+
+} // namespace
+
+uint64_t geohashBits(double latitude, double longitude)
+{
+    return (spreadBits(scaleCoordinate(longitude, -180.0, 360.0)) << 1) | spreadBits(scaleCoordinate(latitude, -90.0, 180.0));
+}
+
+void geohashBits(const double *latitudes, const double *longitudes, uint64_t *hashes, size_t count)
+{
+    for (size_t i = 0; i != count; ++i) {
+        hashes[i] = geohashBits(latitudes[i], longitudes[i]);
+    }
+}
+
+string geohashString(uint64_t bits, unsigned int precision)
+{
+    precision = min(precision, static_cast<unsigned int>(GEOHASH_MAX_PRECISION));
+    string geohash(precision, '0');
+    for (unsigned int i = 0; i != precision; ++i) {
+        geohash[i] = geohashAlphabet[(bits >> (59 - 5 * i)) & 0x1F];
+    }
+    return geohash;
+}
+
+string encodeGeohash(const Location &location, unsigned int precision)
+{
+    Angle longitude(location.longitude());
+    longitude.adjust180To180();
+    return geohashString(geohashBits(location.latitude().degreeValue(), longitude.degreeValue()), precision);
+}
+
+Location decodeGeohash(const string &geohash)
+{
+    if (geohash.empty() || geohash.size() > GEOHASH_MAX_PRECISION) {
+        throw ParseError("Geohash with 1 to 12 characters required.");
+    }
+    uint64_t bits = 0;
+    for (size_t i = 0; i != geohash.size(); ++i) {
+        const char *const digit = find(begin(geohashAlphabet), end(geohashAlphabet) - 1, static_cast<char>(tolower(geohash[i])));
+        if (digit == end(geohashAlphabet) - 1) {
+            throw ParseError("Invalid character in geohash \"" + geohash + "\".");
+        }
+        bits |= static_cast<uint64_t>(digit - geohashAlphabet) << (59 - 5 * i);
+    }
+    // return the center of the cell
+    const unsigned int bitCount = static_cast<unsigned int>(geohash.size()) * 5;
+    const unsigned int lonBits = (bitCount + 1) / 2, latBits = bitCount / 2;
+    const double lat = (compactBits(bits) + ldexp(1.0, 32 - static_cast<int>(latBits)) / 2.0) / 4294967296.0 * 180.0 - 90.0;
+    const double lon = (compactBits(bits >> 1) + ldexp(1.0, 32 - static_cast<int>(lonBits)) / 2.0) / 4294967296.0 * 360.0 - 180.0;
+    return Location(Angle(lat, Angle::AngularMeasure::Degree), Angle(lon, Angle::AngularMeasure::Degree));
+}
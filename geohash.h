@@ -0,0 +1,16 @@
+#ifndef GEOHASH_H
+#define GEOHASH_H
+
+#include "./location.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+std::uint64_t geohashBits(double latitude, double longitude);
+void geohashBits(const double *latitudes, const double *longitudes, std::uint64_t *hashes, std::size_t count);
+std::string geohashString(std::uint64_t bits, unsigned int precision = 12);
+std::string encodeGeohash(const Location &location, unsigned int precision = 12);
+Location decodeGeohash(const std::string &geohash);
+
+#endif // GEOHASH_H
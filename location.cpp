@@ -1,8 +1,10 @@
 #include "./location.h"
+#include "./locationstorage.h"
 
 #include <c++utilities/misc/parseerror.h>
 #include <c++utilities/conversion/stringconversion.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <sstream>
@@ -48,18 +50,25 @@ Location::Location(const string &lat, const string &lon, Angle::AngularMeasure m
 {
 }
 
-Location::Location(const string &latitudeAndLongitude, Angle::AngularMeasure measure)
+Location::Location(string_view latitudeAndLongitude, Angle::AngularMeasure measure)
     : m_ele(0.0)
 {
-    string::size_type dpos = latitudeAndLongitude.find(',');
-    if (dpos == string::npos)
+    string_view::size_type dpos = latitudeAndLongitude.find(',');
+    if (dpos == string_view::npos)
         throw ParseError("Pair of coordinates (latitude and longitude) required.");
     else if (dpos >= (latitudeAndLongitude.length() - 1))
         throw ParseError("No second longitude following after comma.");
-    else if (latitudeAndLongitude.find(',', dpos + 1) != string::npos)
-        throw ParseError("More then 2 coordinates given.");
+    // the longitude might be followed by the elevation in meters
+    const string_view::size_type epos = latitudeAndLongitude.find(',', dpos + 1);
+    if (epos != string_view::npos) {
+        if (epos >= (latitudeAndLongitude.length() - 1))
+            throw ParseError("No elevation following after second comma.");
+        else if (latitudeAndLongitude.find(',', epos + 1) != string_view::npos)
+            throw ParseError("More then 3 coordinates given.");
+        m_ele = numberFromString(latitudeAndLongitude.substr(epos + 1));
+    }
     m_lat = Angle(latitudeAndLongitude.substr(0, dpos), measure);
-    m_lon = Angle(latitudeAndLongitude.substr(dpos + 1), measure);
+    m_lon = Angle(latitudeAndLongitude.substr(dpos + 1, epos - dpos - 1), measure);
 }
 
 Location::~Location()
@@ -83,6 +92,16 @@ string Location::toUtmWgs4String() const
     return ss.str();
 }
 
+string Location::toEcefString() const
+{
+    double x, y, z;
+    computeEcefCoordinates(x, y, z);
+    stringstream ss(stringstream::in | stringstream::out);
+    ss << setprecision(3) << fixed;
+    ss << x << "," << y << "," << z;
+    return ss.str();
+}
+
 double Location::distanceTo(const Location &location) const
 {
     double lat1 = m_lat.radianValue();
@@ -128,6 +147,26 @@ Location Location::destination(double distance, const Angle &bearing)
     return Location(Angle(lat2), Angle(lon2));
 }
 
+double Location::crossTrackDistanceTo(const Location &pathStart, const Location &pathEnd) const
+{
+    // negative values indicate the location is left of the path
+    double ad13 = pathStart.distanceTo(*this) / m_er;
+    double brng13 = pathStart.initialBearingTo(*this).radianValue();
+    double brng12 = pathStart.initialBearingTo(pathEnd).radianValue();
+    return asin(sin(ad13) * sin(brng13 - brng12)) * m_er;
+}
+
+double Location::alongTrackDistanceTo(const Location &pathStart, const Location &pathEnd) const
+{
+    // negative values indicate the closest point on the great circle is before the start of the path
+    double ad13 = pathStart.distanceTo(*this) / m_er;
+    double brng13 = pathStart.initialBearingTo(*this).radianValue();
+    double brng12 = pathStart.initialBearingTo(pathEnd).radianValue();
+    double adxt = asin(sin(ad13) * sin(brng13 - brng12));
+    double adat = acos(std::min(1.0, cos(ad13) / cos(adxt)));
+    return (cos(brng12 - brng13) < 0.0 ? -adat : adat) * m_er;
+}
+
 void Location::computeUtmWgs4Coordinates(int &zone, char &zoneDesignator, double &east, double &north) const
 {
     double a = WGS84_A;
@@ -195,19 +234,57 @@ Location Location::midpoint(const Location &location1, const Location &location2
     return Location(Angle(atan2(sin(lat1) + sin(lat2), sqrt((cos(lat1) + x) * (cos(lat1) + x) + y * y))), Angle(lon1 + atan2(y, cos(lat1) + x)));
 }
 
-double Location::trackLength(const std::vector<Location> &track, bool circle)
+Location Location::intermediatePoint(const Location &location1, const Location &location2, double fraction)
+{
+    double lat, lon;
+    intermediatePoints(location1, location2, &fraction, 1, &lat, &lon);
+    return Location(Angle(lat), Angle(lon));
+}
+
+void Location::intermediatePoints(const Location &location1, const Location &location2, const double *__restrict fractions,
+    std::size_t count, double *__restrict latitudes, double *__restrict longitudes)
+{
+    double lat1 = location1.m_lat.radianValue();
+    double lon1 = location1.m_lon.radianValue();
+    double lat2 = location2.m_lat.radianValue();
+    double lon2 = location2.m_lon.radianValue();
+    double ad = location1.distanceTo(location2) / m_er;
+    double sinad = sin(ad);
+    if (sinad == 0.0) {
+        for (std::size_t i = 0; i != count; ++i) {
+            latitudes[i] = lat1;
+            longitudes[i] = lon1;
+        }
+        return;
+    }
+    // cartesian coordinates of the end points on the unit sphere
+    double x1 = cos(lat1) * cos(lon1), y1 = cos(lat1) * sin(lon1), z1 = sin(lat1);
+    double x2 = cos(lat2) * cos(lon2), y2 = cos(lat2) * sin(lon2), z2 = sin(lat2);
+    // only works on arrays of doubles so it can be vectorized, see geodeticToEcef()
+    const double inverseSinad = 1.0 / sinad;
+    for (std::size_t i = 0; i != count; ++i) {
+        const double a = sin((1.0 - fractions[i]) * ad) * inverseSinad;
+        const double b = sin(fractions[i] * ad) * inverseSinad;
+        const double x = a * x1 + b * x2, y = a * y1 + b * y2, z = a * z1 + b * z2;
+        latitudes[i] = atan2(z, sqrt(x * x + y * y));
+        longitudes[i] = atan2(y, x);
+    }
+}
+
+namespace {
+
+template <typename Track> double computeTrackLength(const Track &track, bool circle)
 {
     if (track.size() < 2)
         throw ParseError("At least two locations are required to calculate a distance.");
 
-    const Location *location1 = &track.at(0);
-    const Location *location2 = &track.at(1);
-    double distance = location1->distanceTo(*location2);
-
-    for (std::vector<Location>::const_iterator i = track.cbegin() + 2, end = track.cend(); i != end; ++i) {
-        location1 = location2;
-        location2 = &(*i);
+    auto i = track.begin(), end = track.end();
+    const Location *location1 = &(*i);
+    double distance = 0.0;
+    for (++i; i != end; ++i) {
+        const Location *location2 = &(*i);
         distance += location1->distanceTo(*location2);
+        location1 = location2;
     }
 
     if (circle)
@@ -216,6 +293,18 @@ double Location::trackLength(const std::vector<Location> &track, bool circle)
     return distance;
 }
 
+} // namespace
+
+double Location::trackLength(const std::vector<Location> &track, bool circle)
+{
+    return computeTrackLength(track, circle);
+}
+
+double Location::trackLength(const LocationStorage &track, bool circle)
+{
+    return computeTrackLength(track, circle);
+}
+
 double Location::earthRadius()
 {
     return m_er;
@@ -332,4 +421,87 @@ void Location::setValueByProvidedUtmWgs4Coordinates(int zone, char zoneDesignato
     m_lon.adjust180To180();
 }
 
+void Location::computeEcefCoordinates(double &x, double &y, double &z) const
+{
+    double lat = m_lat.radianValue();
+    double lon = m_lon.radianValue();
+    geodeticToEcef(&lat, &lon, &m_ele, &x, &y, &z, 1);
+}
+
+void Location::setValueByProvidedEcefCoordinates(const string &ecefCoordinates)
+{
+    string::size_type ypos = ecefCoordinates.find(',');
+    if (ypos != string::npos) {
+        string::size_type zpos = ecefCoordinates.find(',', ypos + 1);
+        if (zpos < (ecefCoordinates.length() - 1) && zpos != string::npos) {
+            if (ecefCoordinates.find(',', zpos + 1) != string::npos)
+                throw ParseError("More then 3 ECEF coordinates given.");
+            double x = stringToNumber<double>(ecefCoordinates.substr(0, ypos));
+            double y = stringToNumber<double>(ecefCoordinates.substr(ypos + 1, zpos - ypos - 1));
+            double z = stringToNumber<double>(ecefCoordinates.substr(zpos + 1));
+            setValueByProvidedEcefCoordinates(x, y, z);
+            return;
+        }
+    }
+    throw ParseError("ECEF coordinates (X, Y and Z) incomplete.");
+}
+
+void Location::setValueByProvidedEcefCoordinates(double x, double y, double z)
+{
+    double lat, lon;
+    ecefToGeodetic(&x, &y, &z, &lat, &lon, &m_ele, 1);
+    m_lat = Angle(lat);
+    m_lon = Angle(lon);
+}
+
+void Location::geodeticToEcef(
+    const double *__restrict lat, const double *__restrict lon, const double *__restrict height, double *__restrict x,
+    double *__restrict y, double *__restrict z, std::size_t count)
+{
+    constexpr double halfPi = 1.57079632679489661923;
+    // the loops of the batch functions only work on non-aliasing arrays of doubles so they are vectorized when SIMD variants of
+    // the math functions are available (e.g. GCC with -ffast-math and glibc's libmvec); the cosine is computed as sine of the
+    // shifted angle as GCC would otherwise combine both into sincos() which it can not vectorize
+    for (std::size_t i = 0; i != count; ++i) {
+        double sinlat = sin(lat[i]);
+        double coslat = sin(lat[i] + halfPi);
+        double N = WGS84_A / sqrt(1.0 - UTM_E2 * sinlat * sinlat);
+        x[i] = (N + height[i]) * coslat * sin(lon[i] + halfPi);
+        y[i] = (N + height[i]) * coslat * sin(lon[i]);
+        z[i] = (N * (1.0 - UTM_E2) + height[i]) * sinlat;
+    }
+}
+
+void Location::ecefToGeodetic(
+    const double *__restrict x, const double *__restrict y, const double *__restrict z, double *__restrict lat, double *__restrict lon,
+    double *__restrict height, std::size_t count)
+{
+    // closed-form solution by Heikkinen (1982)
+    const double a2 = WGS84_A * WGS84_A;
+    const double b2 = WGS84_B * WGS84_B;
+    const double e4 = UTM_E2 * UTM_E2;
+    const double ep2 = (a2 - b2) / b2;
+    for (std::size_t i = 0; i != count; ++i) {
+        double p2 = x[i] * x[i] + y[i] * y[i];
+        double p = sqrt(p2);
+        double z2 = z[i] * z[i];
+        double F = 54.0 * b2 * z2;
+        double G = p2 + (1.0 - UTM_E2) * z2 - UTM_E2 * (a2 - b2);
+        double c = e4 * F * p2 / (G * G * G);
+        double s = cbrt(1.0 + c + sqrt(c * c + 2.0 * c));
+        double k = s + 1.0 + 1.0 / s;
+        double P = F / (3.0 * k * k * G * G);
+        double Q = sqrt(1.0 + 2.0 * e4 * P);
+        double r0
+            = -(P * UTM_E2 * p) / (1.0 + Q) + sqrt(a2 / 2.0 * (1.0 + 1.0 / Q) - P * (1.0 - UTM_E2) * z2 / (Q * (1.0 + Q)) - P * p2 / 2.0);
+        double d = p - UTM_E2 * r0;
+        double U = sqrt(d * d + z2);
+        double V = sqrt(d * d + (1.0 - UTM_E2) * z2);
+        double z0 = b2 * z[i] / (WGS84_A * V);
+        height[i] = U * (1.0 - b2 / (WGS84_A * V));
+        lat[i] = atan2(z[i] + ep2 * z0, p);
+        lon[i] = atan2(y[i], x[i]);
+    }
+}
+
 const double Location::m_er = 6371000.0;
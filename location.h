@@ -3,17 +3,21 @@
 
 #include "./angle.h"
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <vector>
 
+class LocationStorage;
+
 class Location {
 public:
-    enum class GeographicCoordinateSystem { LatitudeAndLongitude, UTMWGS84 };
+    enum class GeographicCoordinateSystem { LatitudeAndLongitude, UTMWGS84, ECEF };
 
     Location();
     Location(const Angle &lat, const Angle &lon);
     explicit Location(const std::string &lat, const std::string &lon, Angle::AngularMeasure measure = Angle::AngularMeasure::Radian);
-    explicit Location(const std::string &latitudeAndLongitude, Angle::AngularMeasure measure = Angle::AngularMeasure::Radian);
+    explicit Location(std::string_view latitudeAndLongitude, Angle::AngularMeasure measure = Angle::AngularMeasure::Radian);
     ~Location();
 
     const Angle &latitude() const;
@@ -24,17 +28,33 @@ public:
     void setElevation(double value);
     std::string toString(Angle::OutputForm form = Angle::OutputForm::Degrees) const;
     std::string toUtmWgs4String() const;
+    std::string toEcefString() const;
     bool isEmpty() const;
     double distanceTo(const Location &location) const;
     Angle initialBearingTo(const Location &location) const;
     Angle finalBearingTo(const Location &location) const;
     Location destination(double distance, const Angle &bearing);
+    double crossTrackDistanceTo(const Location &pathStart, const Location &pathEnd) const;
+    double alongTrackDistanceTo(const Location &pathStart, const Location &pathEnd) const;
     void computeUtmWgs4Coordinates(int &zone, char &zoneDesignator, double &east, double &north) const;
     char computeUtmZoneDesignator() const;
     void setValueByProvidedUtmWgs4Coordinates(const std::string &utmWgs4Coordinates);
     void setValueByProvidedUtmWgs4Coordinates(int zone, char zoneDesignator, double east, double north);
+    void computeEcefCoordinates(double &x, double &y, double &z) const;
+    void setValueByProvidedEcefCoordinates(const std::string &ecefCoordinates);
+    void setValueByProvidedEcefCoordinates(double x, double y, double z);
+    static void geodeticToEcef(
+        const double *__restrict lat, const double *__restrict lon, const double *__restrict height, double *__restrict x,
+        double *__restrict y, double *__restrict z, std::size_t count);
+    static void ecefToGeodetic(
+        const double *__restrict x, const double *__restrict y, const double *__restrict z, double *__restrict lat, double *__restrict lon,
+        double *__restrict height, std::size_t count);
     static Location midpoint(const Location &location1, const Location &location2);
+    static Location intermediatePoint(const Location &location1, const Location &location2, double fraction);
+    static void intermediatePoints(const Location &location1, const Location &location2, const double *__restrict fractions,
+        std::size_t count, double *__restrict latitudes, double *__restrict longitudes);
     static double trackLength(const std::vector<Location> &track, bool circle = false);
+    static double trackLength(const LocationStorage &track, bool circle = false);
     static double earthRadius();
     static Angle angularDistance(double distance);
 
@@ -0,0 +1,229 @@
+#include "./locationpipeline.h"
+#include "./parallel.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct TextBlock {
+    size_t index = 0;
+    string data;
+    exception_ptr error;
+};
+
+struct ParsedBlock {
+    vector<TrackPoint> points;
+    exception_ptr error;
+};
+
+// The reader thread splits the stream into blocks of whole lines which are parsed by the parser threads. The parsed blocks
+// are handed to the consumer in their original order. Both queues are bounded so memory usage does not depend on the input size.
+class LocationPipeline {
+public:
+    LocationPipeline(istream &stream, const function<TrackPoint(const string &line)> &parse, unsigned int parserCount, size_t blockSize);
+    ~LocationPipeline();
+
+    void run(const function<void(const TrackPoint &)> &callback);
+
+private:
+    void read();
+    void parseBlocks();
+    void stop();
+
+    istream &m_stream;
+    const function<TrackPoint(const string &line)> &m_parse;
+    const size_t m_blockSize;
+    const size_t m_queueCapacity;
+    mutex m_mutex;
+    condition_variable m_textAvailable;
+    condition_variable m_textSpace;
+    condition_variable m_parsedAvailable;
+    condition_variable m_parsedSpace;
+    deque<TextBlock> m_textBlocks;
+    map<size_t, ParsedBlock> m_parsedBlocks;
+    size_t m_blockCount;
+    size_t m_nextToConsume;
+    bool m_readingDone;
+    bool m_stopped;
+    vector<thread> m_threads;
+};
+
+LocationPipeline::LocationPipeline(
+    istream &stream, const function<TrackPoint(const string &line)> &parse, unsigned int parserCount, size_t blockSize)
+    : m_stream(stream)
+    , m_parse(parse)
+    , m_blockSize(blockSize)
+    , m_queueCapacity(2 * parserCount)
+    , m_blockCount(0)
+    , m_nextToConsume(0)
+    , m_readingDone(false)
+    , m_stopped(false)
+{
+    m_threads.reserve(parserCount + 1);
+    m_threads.emplace_back(&LocationPipeline::read, this);
+    for (unsigned int i = 0; i != parserCount; ++i) {
+        m_threads.emplace_back(&LocationPipeline::parseBlocks, this);
+    }
+}
+
+LocationPipeline::~LocationPipeline()
+{
+    stop();
+    for (thread &t : m_threads) {
+        t.join();
+    }
+}
+
+void LocationPipeline::stop()
+{
+    const lock_guard<mutex> lock(m_mutex);
+    m_stopped = true;
+    m_textAvailable.notify_all();
+    m_textSpace.notify_all();
+    m_parsedAvailable.notify_all();
+    m_parsedSpace.notify_all();
+}
+
+void LocationPipeline::read()
+{
+    string carry;
+    for (size_t index = 0;; ++index) {
+        TextBlock block;
+        block.index = index;
+        bool eof = false;
+        try {
+            // read a block and move the incomplete last line over to the next block
+            block.data.swap(carry);
+            auto lastLineEnd = string::npos;
+            do {
+                const auto offset = block.data.size();
+                block.data.resize(offset + m_blockSize);
+                m_stream.read(&block.data[offset], static_cast<streamsize>(m_blockSize));
+                block.data.resize(offset + static_cast<size_t>(m_stream.gcount()));
+                eof = !m_stream;
+            } while (!eof && (lastLineEnd = block.data.rfind('\n')) == string::npos);
+            if (!eof) {
+                carry.assign(block.data, lastLineEnd + 1, string::npos);
+                block.data.resize(lastLineEnd + 1);
+            }
+        } catch (...) {
+            block.error = current_exception();
+            eof = true;
+        }
+
+        unique_lock<mutex> lock(m_mutex);
+        m_textSpace.wait(lock, [this] { return m_stopped || m_textBlocks.size() < m_queueCapacity; });
+        if (m_stopped) {
+            return;
+        }
+        m_textBlocks.emplace_back(move(block));
+        if (eof) {
+            m_readingDone = true;
+            m_blockCount = index + 1;
+            m_textAvailable.notify_all();
+            m_parsedAvailable.notify_all();
+            return;
+        }
+        m_textAvailable.notify_one();
+    }
+}
+
+void LocationPipeline::parseBlocks()
+{
+    for (;;) {
+        TextBlock block;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_textAvailable.wait(lock, [this] { return m_stopped || !m_textBlocks.empty() || m_readingDone; });
+            if (m_stopped || m_textBlocks.empty()) {
+                return;
+            }
+            block = move(m_textBlocks.front());
+            m_textBlocks.pop_front();
+            m_textSpace.notify_one();
+        }
+
+        ParsedBlock parsed;
+        parsed.error = block.error;
+        if (!parsed.error) {
+            try {
+                // allocate the points of the block at once rather than growing the vector line by line
+                parsed.points.reserve(static_cast<size_t>(count(block.data.begin(), block.data.end(), '\n')) + 1);
+                string line;
+                for (size_t lineStart = 0, size = block.data.size(); lineStart < size;) {
+                    auto lineEnd = block.data.find('\n', lineStart);
+                    if (lineEnd == string::npos) {
+                        lineEnd = size;
+                    }
+                    line.assign(block.data, lineStart, lineEnd - lineStart);
+                    lineStart = lineEnd + 1;
+                    if (!line.empty() && line.back() == '\r')
+                        line.pop_back();
+                    if (line.empty() || line.front() == '#')
+                        continue; // skip empty lines and comments
+                    parsed.points.push_back(m_parse(line));
+                }
+            } catch (...) {
+                parsed.error = current_exception();
+            }
+        }
+
+        unique_lock<mutex> lock(m_mutex);
+        // do not run too far ahead of the consumer
+        m_parsedSpace.wait(lock, [this, &block] { return m_stopped || block.index < m_nextToConsume + m_queueCapacity; });
+        if (m_stopped) {
+            return;
+        }
+        m_parsedBlocks.emplace(block.index, move(parsed));
+        m_parsedAvailable.notify_all();
+    }
+}
+
+void LocationPipeline::run(const function<void(const TrackPoint &)> &callback)
+{
+    for (;;) {
+        ParsedBlock parsed;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_parsedAvailable.wait(lock, [this] {
+                return m_parsedBlocks.count(m_nextToConsume) || (m_readingDone && m_nextToConsume >= m_blockCount);
+            });
+            const auto i = m_parsedBlocks.find(m_nextToConsume);
+            if (i == m_parsedBlocks.end()) {
+                return;
+            }
+            parsed = move(i->second);
+            m_parsedBlocks.erase(i);
+            ++m_nextToConsume;
+            m_parsedSpace.notify_all();
+        }
+        if (parsed.error) {
+            rethrow_exception(parsed.error);
+        }
+        for (const TrackPoint &point : parsed.points) {
+            callback(point);
+        }
+    }
+}
+
+} // namespace
+
+void forEachTrackPointPipelined(istream &stream, const function<TrackPoint(const string &line)> &parse,
+    const function<void(const TrackPoint &)> &callback, unsigned int parserCount, size_t blockSize)
+{
+    if (!parserCount) {
+        parserCount = workerThreadCount() > 2 ? workerThreadCount() - 2 : 1;
+    }
+    LocationPipeline pipeline(stream, parse, parserCount, blockSize);
+    pipeline.run(callback);
+}
@@ -0,0 +1,14 @@
+#ifndef LOCATIONPIPELINE_H
+#define LOCATIONPIPELINE_H
+
+#include "./trackpoint.h"
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+
+void forEachTrackPointPipelined(std::istream &stream, const std::function<TrackPoint(const std::string &line)> &parse,
+    const std::function<void(const TrackPoint &)> &callback, unsigned int parserCount = 0, std::size_t blockSize = 1024 * 1024);
+
+#endif // LOCATIONPIPELINE_H
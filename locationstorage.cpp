@@ -0,0 +1,141 @@
+#include "./locationstorage.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t chunkBytes = LocationStorage::chunkCapacity * sizeof(Location);
+constexpr size_t hugePageBytes = 2 * 1024 * 1024;
+static_assert(!(chunkBytes % hugePageBytes), "chunks must consist of whole huge pages so they can be mapped with MAP_HUGETLB");
+
+Location *allocateChunk(bool useHugePages)
+{
+#if defined(__linux__)
+    if (useHugePages) {
+        // try explicit huge pages first
+#ifdef MAP_HUGE_2MB
+        constexpr int hugePageFlags = MAP_HUGETLB | MAP_HUGE_2MB;
+#else
+        constexpr int hugePageFlags = MAP_HUGETLB;
+#endif
+        void *const chunk = mmap(nullptr, chunkBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | hugePageFlags, -1, 0);
+        if (chunk != MAP_FAILED) {
+            return static_cast<Location *>(chunk);
+        }
+
+        // fall back to transparent huge pages which are only used for 2 MiB aligned ranges; so map an additional huge page
+        // and unmap the unaligned head and tail
+        void *const mapping = mmap(nullptr, chunkBytes + hugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw bad_alloc();
+        }
+        const auto mappingAddress = reinterpret_cast<uintptr_t>(mapping);
+        const auto chunkAddress = (mappingAddress + hugePageBytes - 1) & ~(static_cast<uintptr_t>(hugePageBytes) - 1);
+        if (const auto headBytes = chunkAddress - mappingAddress) {
+            munmap(mapping, headBytes);
+        }
+        if (const auto tailBytes = hugePageBytes - (chunkAddress - mappingAddress)) {
+            munmap(reinterpret_cast<void *>(chunkAddress + chunkBytes), tailBytes);
+        }
+        auto *const alignedChunk = reinterpret_cast<Location *>(chunkAddress);
+#ifdef MADV_HUGEPAGE
+        madvise(alignedChunk, chunkBytes, MADV_HUGEPAGE);
+#endif
+        return alignedChunk;
+    }
+#else
+    (void)useHugePages;
+#endif
+    return static_cast<Location *>(::operator new(chunkBytes));
+}
+
+void freeChunk(Location *chunk, bool useHugePages)
+{
+#if defined(__linux__)
+    if (useHugePages) {
+        // can not be propagated as chunks are also freed when destructing
+        if (munmap(chunk, chunkBytes)) {
+            cerr << "Unable to unmap chunk of locations." << endl;
+        }
+        return;
+    }
+#else
+    (void)useHugePages;
+#endif
+    ::operator delete(chunk);
+}
+
+} // namespace
+
+LocationStorage::LocationStorage(bool useHugePages)
+    : m_size(0)
+    , m_useHugePages(useHugePages)
+{
+}
+
+LocationStorage::LocationStorage(LocationStorage &&other) noexcept
+    : m_chunks(move(other.m_chunks))
+    , m_size(other.m_size)
+    , m_useHugePages(other.m_useHugePages)
+{
+    other.m_chunks.clear();
+    other.m_size = 0;
+}
+
+LocationStorage &LocationStorage::operator=(LocationStorage &&other) noexcept
+{
+    if (this != &other) {
+        clear();
+        m_chunks = move(other.m_chunks);
+        m_size = other.m_size;
+        m_useHugePages = other.m_useHugePages;
+        other.m_chunks.clear();
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+LocationStorage::~LocationStorage()
+{
+    clear();
+}
+
+const Location &LocationStorage::at(size_t index) const
+{
+    if (index >= m_size) {
+        throw out_of_range("location index out of range");
+    }
+    return (*this)[index];
+}
+
+void LocationStorage::clear()
+{
+    for (size_t i = 0; i != m_size; ++i) {
+        m_chunks[i / chunkCapacity][i % chunkCapacity].~Location();
+    }
+    for (Location *chunk : m_chunks) {
+        freeChunk(chunk, m_useHugePages);
+    }
+    m_chunks.clear();
+    m_size = 0;
+}
+
+void LocationStorage::appendChunk()
+{
+    Location *const chunk = allocateChunk(m_useHugePages);
+    try {
+        m_chunks.push_back(chunk);
+    } catch (...) {
+        freeChunk(chunk, m_useHugePages);
+        throw;
+    }
+}
@@ -0,0 +1,165 @@
+#ifndef LOCATIONSTORAGE_H
+#define LOCATIONSTORAGE_H
+
+#include "./location.h"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <vector>
+
+class LocationStorage {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Location;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Location *;
+        using reference = const Location &;
+
+        const_iterator();
+        reference operator*() const;
+        pointer operator->() const;
+        const_iterator &operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+
+    private:
+        friend class LocationStorage;
+        const_iterator(const LocationStorage *storage, std::size_t index);
+        const LocationStorage *m_storage;
+        std::size_t m_index;
+        const Location *m_current;
+    };
+
+    explicit LocationStorage(bool useHugePages = false);
+    LocationStorage(LocationStorage &&other) noexcept;
+    LocationStorage &operator=(LocationStorage &&other) noexcept;
+    LocationStorage(const LocationStorage &) = delete;
+    LocationStorage &operator=(const LocationStorage &) = delete;
+    ~LocationStorage();
+
+    std::size_t size() const;
+    bool empty() const;
+    const Location &operator[](std::size_t index) const;
+    const Location &at(std::size_t index) const;
+    const Location &front() const;
+    const Location &back() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+    void push_back(const Location &location);
+    void clear();
+
+    // power of two so indexing compiles to shifts; with 24 byte locations a chunk takes 6 MiB which is exactly three 2 MiB huge pages
+    static constexpr std::size_t chunkCapacity = 262144;
+
+private:
+    void appendChunk();
+
+    std::vector<Location *> m_chunks;
+    std::size_t m_size;
+    bool m_useHugePages;
+};
+
+inline std::size_t LocationStorage::size() const
+{
+    return m_size;
+}
+
+inline bool LocationStorage::empty() const
+{
+    return !m_size;
+}
+
+inline const Location &LocationStorage::operator[](std::size_t index) const
+{
+    return m_chunks[index / chunkCapacity][index % chunkCapacity];
+}
+
+inline const Location &LocationStorage::front() const
+{
+    return m_chunks.front()[0];
+}
+
+inline const Location &LocationStorage::back() const
+{
+    return (*this)[m_size - 1];
+}
+
+inline LocationStorage::const_iterator LocationStorage::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+inline LocationStorage::const_iterator LocationStorage::end() const
+{
+    return const_iterator(this, m_size);
+}
+
+inline void LocationStorage::push_back(const Location &location)
+{
+    const std::size_t offset = m_size % chunkCapacity;
+    if (!offset && m_size / chunkCapacity == m_chunks.size()) {
+        appendChunk();
+    }
+    new (m_chunks[m_size / chunkCapacity] + offset) Location(location);
+    ++m_size;
+}
+
+inline LocationStorage::const_iterator::const_iterator()
+    : m_storage(nullptr)
+    , m_index(0)
+    , m_current(nullptr)
+{
+}
+
+inline LocationStorage::const_iterator::const_iterator(const LocationStorage *storage, std::size_t index)
+    : m_storage(storage)
+    , m_index(index)
+    , m_current(index < storage->m_size ? &(*storage)[index] : nullptr)
+{
+}
+
+inline LocationStorage::const_iterator::reference LocationStorage::const_iterator::operator*() const
+{
+    return *m_current;
+}
+
+inline LocationStorage::const_iterator::pointer LocationStorage::const_iterator::operator->() const
+{
+    return m_current;
+}
+
+inline LocationStorage::const_iterator &LocationStorage::const_iterator::operator++()
+{
+    // only consult the chunk table when crossing a chunk boundary
+    if (++m_index >= m_storage->m_size) {
+        m_current = nullptr;
+    } else if (m_index % chunkCapacity) {
+        ++m_current;
+    } else {
+        m_current = m_storage->m_chunks[m_index / chunkCapacity];
+    }
+    return *this;
+}
+
+inline LocationStorage::const_iterator LocationStorage::const_iterator::operator++(int)
+{
+    const_iterator copy(*this);
+    ++*this;
+    return copy;
+}
+
+inline bool LocationStorage::const_iterator::operator==(const const_iterator &other) const
+{
+    return m_index == other.m_index;
+}
+
+inline bool LocationStorage::const_iterator::operator!=(const const_iterator &other) const
+{
+    return m_index != other.m_index;
+}
+
+#endif // LOCATIONSTORAGE_H
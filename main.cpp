@@ -1,15 +1,29 @@
 #include "./main.h"
+#include "./clustering.h"
+#include "./fixedlocation.h"
+#include "./geohash.h"
 #include "./location.h"
+#include "./locationpipeline.h"
+#include "./parallel.h"
+#include "./polyline.h"
+#include "./routeindex.h"
+#include "./spatialsort.h"
+#include "./trackcodec.h"
+#include "./trackstatistics.h"
 
 #include "resources/config.h"
 
 #include <c++utilities/application/argumentparser.h>
+#include <c++utilities/chrono/datetime.h>
 #include <c++utilities/misc/parseerror.h>
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
 
+#include <algorithm>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 
 using namespace std;
@@ -19,6 +33,10 @@ Angle::AngularMeasure inputAngularMeasure = Angle::AngularMeasure::Degree;
 Angle::OutputForm outputFormForAngles = Angle::OutputForm::Degrees;
 SystemForLocations inputSystemForLocations = SystemForLocations::LatitudeLongitude;
 SystemForLocations outputSystemForLocations = SystemForLocations::LatitudeLongitude;
+unsigned int geohashPrecision = 12;
+bool useHugePagesForLocations = false;
+unique_ptr<MemoCache<Location>> locationCache;
+unique_ptr<MemoCache<string>> conversionCache;
 
 int main(int argc, char *argv[])
 {
@@ -26,9 +44,13 @@ int main(int argc, char *argv[])
 
     ArgumentParser argparser;
 
-    Argument convert("convert", 'c', "Converts the given coordinate or location to the specified output form.");
-    convert.setRequiredValueCount(1);
+    Argument convert("convert", 'c', "Converts the given coordinates or locations to the specified output form.");
+    convert.setRequiredValueCount(Argument::varValueCount);
     convert.appendValueName("coordinate/location");
+    Argument convertFileArg("file", 'f', "Specifies a file containing coordinates or locations separated by new lines to be converted");
+    convertFileArg.setRequiredValueCount(1);
+    convertFileArg.appendValueName("path");
+    convert.setSubArguments({ &convertFileArg });
 
     Argument distance("distance", 'd', "Computes the approximate distance in meters between two locations.");
     distance.setRequiredValueCount(2);
@@ -36,14 +58,33 @@ int main(int argc, char *argv[])
     distance.appendValueName("location 2");
 
     Argument trackLength("track-length", 't',
-        "Computes the approximate length in meters of a track given by a file containing trackpoints separated by new lines.");
-    Argument fileArg("file", 'f', "Specifies the file containing the track points");
-    fileArg.setRequiredValueCount(1);
+        "Computes the approximate length in meters of a track given by a file containing trackpoints separated by new lines. If multiple "
+        "tracks are specified they are processed in parallel and a line \"path,length,points\" is printed for each track.");
+    Argument fileArg("file", 'f', "Specifies the files containing the track points (directories are searched for track files)");
+    fileArg.setRequiredValueCount(Argument::varValueCount);
     fileArg.appendValueName("path");
-    fileArg.setRequired(true);
+    Argument manifestArg("manifest", '\0', "Specifies a file containing paths of track files separated by new lines");
+    manifestArg.setRequiredValueCount(1);
+    manifestArg.appendValueName("path");
     Argument circle(
         "circle", '\0', "If present the distance between the first and the last trackpoints will be added to the total track length.");
-    trackLength.setSubArguments({ &fileArg, &circle });
+    trackLength.setSubArguments({ &fileArg, &manifestArg, &circle });
+
+    Argument trackStats("track-stats", '\0',
+        "Computes length, duration, average and maximum speed and stops of a track given by a file containing trackpoints separated by new "
+        "lines. Each trackpoint might be followed by a timestamp (seconds since the Unix epoch or ISO 8601) separated by white space.");
+    Argument trackStatsFileArg("file", 'f', "Specifies the file containing the track points");
+    trackStatsFileArg.setRequiredValueCount(1);
+    trackStatsFileArg.appendValueName("path");
+    trackStatsFileArg.setRequired(true);
+    Argument stopSpeedArg(
+        "stop-speed", '\0', "Specifies the speed in meters per second below which the track is considered stopped (default is 0.5)");
+    stopSpeedArg.setRequiredValueCount(1);
+    stopSpeedArg.appendValueName("speed");
+    Argument stopDurationArg("stop-duration", '\0', "Specifies the minimum duration in seconds of a stop (default is 60)");
+    stopDurationArg.setRequiredValueCount(1);
+    stopDurationArg.appendValueName("duration");
+    trackStats.setSubArguments({ &trackStatsFileArg, &stopSpeedArg, &stopDurationArg });
 
     Argument bearing("bearing", 'b',
         "Computes the approximate initial bearing East of true North when traveling along the shortest path between the given locations.");
@@ -72,6 +113,85 @@ int main(int argc, char *argv[])
         "gmaps-link", '\0', "Generates a Google Maps link for all locations given by a file containing locations separated by new lines.");
     gmapsLink.setRequiredValueCount(1);
     gmapsLink.appendValueName("path");
+    Argument polylineArg("polyline", '\0', "If present the locations will be printed as encoded polyline instead of a link.");
+    Argument geoJsonArg("geojson", '\0', "If present the locations will be printed as GeoJSON LineString instead of a link.");
+    gmapsLink.setSubArguments({ &polylineArg, &geoJsonArg });
+
+    Argument resample("resample", '\0',
+        "Resamples the track given by a file containing trackpoints separated by new lines so consecutive points are exactly the specified "
+        "distance in meters apart (measured along the track).");
+    resample.setRequiredValueCount(1);
+    resample.appendValueName("distance");
+    Argument resampleFileArg("file", 'f', "Specifies the file containing the track points");
+    resampleFileArg.setRequiredValueCount(1);
+    resampleFileArg.appendValueName("path");
+    resampleFileArg.setRequired(true);
+    resample.setSubArguments({ &resampleFileArg });
+
+    Argument encode(
+        "encode", '\0', "Writes the locations of the specified file to the specified output file using the compact track format.");
+    encode.setRequiredValueCount(2);
+    encode.appendValueName("input path");
+    encode.appendValueName("output path");
+    Argument elevationArg("elevation", '\0', "If present the elevation of the locations will be stored as well.");
+    encode.setSubArguments({ &elevationArg });
+
+    Argument decode(
+        "decode", '\0', "Writes the locations of the specified file in the compact track format to the specified output file as text.");
+    decode.setRequiredValueCount(2);
+    decode.appendValueName("input path");
+    decode.appendValueName("output path");
+
+    Argument sortArg("sort", '\0',
+        "Prints the locations of the specified file sorted in the specified order (spatial: along a Hilbert curve so nearby locations are "
+        "stored close to each other).");
+    sortArg.setRequiredValueCount(1);
+    sortArg.appendValueName("order");
+    Argument sortFileArg("file", 'f', "Specifies the file containing the locations");
+    sortFileArg.setRequiredValueCount(1);
+    sortFileArg.appendValueName("path");
+    sortFileArg.setRequired(true);
+    Argument permutationArg(
+        "permutation", '\0', "Specifies a file to write the original (zero-based) index of each printed location to, one per line");
+    permutationArg.setRequiredValueCount(1);
+    permutationArg.appendValueName("path");
+    sortArg.setSubArguments({ &sortFileArg, &permutationArg });
+
+    Argument snapArg("snap", '\0',
+        "Snaps the locations of the specified file onto the route given by a file containing locations separated by new lines. A line "
+        "\"location,segment,offset,distance\" is printed for each location where offset is the distance in meters from the start of the "
+        "segment and distance the distance in meters between the location and the route.");
+    snapArg.setRequiredValueCount(1);
+    snapArg.appendValueName("route path");
+    Argument snapFileArg("file", 'f', "Specifies the file containing the locations to be snapped");
+    snapFileArg.setRequiredValueCount(1);
+    snapFileArg.appendValueName("path");
+    snapFileArg.setRequired(true);
+    snapArg.setSubArguments({ &snapFileArg });
+
+    Argument clusterArg("cluster", '\0',
+        "Clusters the locations of the specified file using DBSCAN and prints each location followed by its cluster ID (-1 for noise). "
+        "Locations within the specified distance in meters are neighbors and a cluster requires a location with at least the specified "
+        "number of neighbors (including itself).");
+    clusterArg.setRequiredValueCount(2);
+    clusterArg.appendValueName("distance");
+    clusterArg.appendValueName("min points");
+    Argument clusterFileArg("file", 'f', "Specifies the file containing the locations");
+    clusterFileArg.setRequiredValueCount(1);
+    clusterFileArg.appendValueName("path");
+    clusterFileArg.setRequired(true);
+    clusterArg.setSubArguments({ &clusterFileArg });
+
+    Argument bucketArg("bucket", '\0',
+        "Groups the locations of the specified file by the geohash prefix with the specified number of characters and prints each "
+        "location preceded by its prefix.");
+    bucketArg.setRequiredValueCount(1);
+    bucketArg.appendValueName("precision");
+    Argument bucketFileArg("file", 'f', "Specifies the file containing the locations");
+    bucketFileArg.setRequiredValueCount(1);
+    bucketFileArg.appendValueName("path");
+    bucketFileArg.setRequired(true);
+    bucketArg.setSubArguments({ &bucketFileArg });
 
     Argument inputAngularMeasureArg("input-angular-measure", 'i',
         "Use this option to specify the angular measure you use to provide angles (degree or radian; default is degree).");
@@ -86,22 +206,40 @@ int main(int argc, char *argv[])
     outputFormForAnglesArg.setCombinable(true);
 
     Argument inputSystemForLocationsArg("input-location-system", '\0',
-        "Use this option to specify the geographic system you use to provide locations (latitude&longitue or UTM-WGS84).");
+        "Use this option to specify the geographic system you use to provide locations (latitude&longitue, UTM-WGS84, ECEF or geohash).");
     inputSystemForLocationsArg.setRequiredValueCount(1);
     inputSystemForLocationsArg.appendValueName("system");
     inputSystemForLocationsArg.setCombinable(true);
 
     Argument outputSystemForLocationsArg("output-location-system", '\0',
-        "Use this option to specify which geographic system is used to display locations (latitude&longitue or UTM-WGS84).");
+        "Use this option to specify which geographic system is used to display locations (latitude&longitue, UTM-WGS84, ECEF or geohash).");
     outputSystemForLocationsArg.setRequiredValueCount(1);
     outputSystemForLocationsArg.appendValueName("system");
     outputSystemForLocationsArg.setCombinable(true);
 
+    Argument geohashPrecisionArg(
+        "geohash-precision", '\0', "Use this option to specify the number of characters of geohashes to display (1 to 12; default is 12).");
+    geohashPrecisionArg.setRequiredValueCount(1);
+    geohashPrecisionArg.appendValueName("precision");
+    geohashPrecisionArg.setCombinable(true);
+
+    Argument cacheSizeArg("cache-size", '\0',
+        "Use this option to cache up to the specified number of parsed and converted inputs which speeds up inputs containing the same "
+        "coordinates many times.");
+    cacheSizeArg.setRequiredValueCount(1);
+    cacheSizeArg.appendValueName("number");
+    cacheSizeArg.setCombinable(true);
+
+    Argument hugePagesArg("huge-pages", '\0', "Use this option to back loaded locations with huge pages (if supported by the system).");
+    hugePagesArg.setCombinable(true);
+
     HelpArgument help(argparser);
 
     Argument version("version", 'v', "Shows the version of this application.");
-    argparser.setMainArguments({ &help, &convert, &distance, &trackLength, &bearing, &fbearing, &midpoint, &destination, &gmapsLink,
-        &inputAngularMeasureArg, &outputFormForAnglesArg, &inputSystemForLocationsArg, &outputSystemForLocationsArg, &version });
+    argparser.setMainArguments({ &help, &convert, &distance, &trackLength, &trackStats, &bearing, &fbearing, &midpoint, &destination,
+        &gmapsLink, &resample, &encode, &decode, &sortArg, &snapArg, &clusterArg, &bucketArg, &inputAngularMeasureArg,
+        &outputFormForAnglesArg, &inputSystemForLocationsArg, &outputSystemForLocationsArg, &geohashPrecisionArg, &cacheSizeArg,
+        &hugePagesArg, &version });
     argparser.parseArgs(argc, argv);
 
     if (inputAngularMeasureArg.isPresent()) {
@@ -138,6 +276,10 @@ int main(int argc, char *argv[])
             inputSystemForLocations = SystemForLocations::LatitudeLongitude;
         } else if (!strcmp(inputFormat, "UTM-WGS84")) {
             inputSystemForLocations = SystemForLocations::UTMWGS84;
+        } else if (!strcmp(inputFormat, "ECEF")) {
+            inputSystemForLocations = SystemForLocations::ECEF;
+        } else if (!strcmp(inputFormat, "geohash")) {
+            inputSystemForLocations = SystemForLocations::Geohash;
         } else {
             cerr << "Invalid geographic coordinate system given, see --help." << endl;
             return 0;
@@ -150,12 +292,42 @@ int main(int argc, char *argv[])
             outputSystemForLocations = SystemForLocations::LatitudeLongitude;
         } else if (!strcmp(outputSystem, "UTM-WGS84")) {
             outputSystemForLocations = SystemForLocations::UTMWGS84;
+        } else if (!strcmp(outputSystem, "ECEF")) {
+            outputSystemForLocations = SystemForLocations::ECEF;
+        } else if (!strcmp(outputSystem, "geohash")) {
+            outputSystemForLocations = SystemForLocations::Geohash;
         } else {
             cerr << "Invalid geographic coordinate system given, see --help." << endl;
             return 0;
         }
     }
 
+    if (geohashPrecisionArg.isPresent()) {
+        try {
+            geohashPrecision = stringToNumber<unsigned int>(geohashPrecisionArg.values().front());
+        } catch (const ConversionException &) {
+            geohashPrecision = 0;
+        }
+        if (geohashPrecision < 1 || geohashPrecision > 12) {
+            cerr << "Invalid geohash precision given, see --help." << endl;
+            return 0;
+        }
+    }
+
+    useHugePagesForLocations = hugePagesArg.isPresent();
+
+    try {
+        if (cacheSizeArg.isPresent()) {
+            // the settings are fixed from now on so the raw input is sufficient as key
+            const auto cacheSize = stringToNumber<size_t>(cacheSizeArg.values().front());
+            locationCache = make_unique<MemoCache<Location>>(cacheSize);
+            conversionCache = make_unique<MemoCache<string>>(cacheSize);
+        }
+    } catch (const ConversionException &) {
+        cerr << "Invalid cache size given, see --help." << endl;
+        return 0;
+    }
+
     try {
         if (help.isPresent()) {
             cout << endl;
@@ -163,11 +335,29 @@ int main(int argc, char *argv[])
         } else if (version.isPresent()) {
             cout << APP_VERSION;
         } else if (convert.isPresent()) {
-            printConversion(convert.values().front());
+            // separate the conversions by new lines; the last one is terminated when exiting
+            bool first = true;
+            for (const char *coordinates : convert.values()) {
+                if (!first) {
+                    cout << '\n';
+                }
+                first = false;
+                printConversion(coordinates);
+            }
+            if (convertFileArg.isPresent()) {
+                printConversions(convertFileArg.values().front(), first);
+            }
         } else if (distance.isPresent()) {
             printDistance(distance.values()[0], distance.values()[1]);
         } else if (trackLength.isPresent()) {
-            printTrackLength(fileArg.values().front(), circle.isPresent());
+            if (!manifestArg.isPresent() && fileArg.values().size() == 1 && !filesystem::is_directory(fileArg.values().front())) {
+                printTrackLength(fileArg.values().front(), circle.isPresent());
+            } else {
+                printTrackLengths(fileArg.values(), manifestArg.isPresent() ? manifestArg.values().front() : nullptr, circle.isPresent());
+            }
+        } else if (trackStats.isPresent()) {
+            printTrackStatistics(trackStatsFileArg.values().front(), stopSpeedArg.isPresent() ? stopSpeedArg.values().front() : "0.5",
+                stopDurationArg.isPresent() ? stopDurationArg.values().front() : "60");
         } else if (bearing.isPresent()) {
             printBearing(bearing.values()[0], bearing.values()[1]);
         } else if (fbearing.isPresent()) {
@@ -177,7 +367,31 @@ int main(int argc, char *argv[])
         } else if (destination.isPresent()) {
             printDestination(destination.values()[0], destination.values()[1], destination.values()[2]);
         } else if (gmapsLink.isPresent()) {
-            printMapsLink(gmapsLink.values().front());
+            if (polylineArg.isPresent()) {
+                printPolyline(gmapsLink.values().front());
+            } else if (geoJsonArg.isPresent()) {
+                printGeoJson(gmapsLink.values().front());
+            } else {
+                printMapsLink(gmapsLink.values().front());
+            }
+        } else if (resample.isPresent()) {
+            printResampledTrack(resampleFileArg.values().front(), resample.values().front());
+        } else if (encode.isPresent()) {
+            encodeTrack(encode.values()[0], encode.values()[1], elevationArg.isPresent());
+        } else if (decode.isPresent()) {
+            decodeTrack(decode.values()[0], decode.values()[1]);
+        } else if (sortArg.isPresent()) {
+            if (strcmp(sortArg.values().front(), "spatial")) {
+                cerr << "Invalid order given, see --help." << endl;
+                return 0;
+            }
+            printSpatiallySorted(sortFileArg.values().front(), permutationArg.isPresent() ? permutationArg.values().front() : nullptr);
+        } else if (snapArg.isPresent()) {
+            printSnappedLocations(snapArg.values().front(), snapFileArg.values().front());
+        } else if (clusterArg.isPresent()) {
+            printClusters(clusterFileArg.values().front(), clusterArg.values()[0], clusterArg.values()[1]);
+        } else if (bucketArg.isPresent()) {
+            printGeohashBuckets(bucketFileArg.values().front(), bucketArg.values().front());
         } else {
             cerr << "No arguments given. See --help for available commands.";
         }
@@ -191,46 +405,141 @@ int main(int argc, char *argv[])
         printAngleFormatInfo(cerr);
     }
 
+    if (locationCache) {
+        printCacheStatistics(cerr);
+    }
+
     cout << endl;
     return 0;
 }
 
-Location locationFromString(const string &userInput)
+Location locationFromString(string_view userInput)
+{
+    if (locationCache) {
+        const string key(userInput);
+        Location location;
+        if (!locationCache->get(key, location)) {
+            location = parseLocation(userInput);
+            locationCache->put(key, location);
+        }
+        return location;
+    }
+    return parseLocation(userInput);
+}
+
+Location parseLocation(string_view userInput)
 {
     switch (inputSystemForLocations) {
     case SystemForLocations::UTMWGS84: {
         Location l;
-        l.setValueByProvidedUtmWgs4Coordinates(userInput);
+        l.setValueByProvidedUtmWgs4Coordinates(string(userInput));
+        return l;
+    }
+    case SystemForLocations::ECEF: {
+        Location l;
+        l.setValueByProvidedEcefCoordinates(string(userInput));
         return l;
     }
+    case SystemForLocations::Geohash:
+        return decodeGeohash(string(userInput));
     default:
         return Location(userInput, inputAngularMeasure);
     }
 }
 
-vector<Location> locationsFromFile(const string &path)
+LocationStorage locationsFromFile(const string &path, bool pipelined)
+{
+    LocationStorage locations(useHugePagesForLocations);
+    forEachLocationFromFile(
+        path, [&locations](const Location &location) { locations.push_back(location); }, pipelined);
+    return locations;
+}
+
+void forEachLocationFromFile(const string &path, const function<void(const Location &)> &callback, bool pipelined)
+{
+    forEachTrackPointFromFile(
+        path, [&callback](const TrackPoint &point) { callback(point.location()); }, pipelined);
+}
+
+void forEachTrackPointFromFile(const string &path, const function<void(const TrackPoint &)> &callback, bool pipelined)
 {
     // prepare reading
     fstream file;
-    file.open(path, ios_base::in);
+    file.open(path, ios_base::in | ios_base::binary);
     if (!file) {
         throw std::ios_base::failure("Unable to open the file \"" % path + "\".");
     }
     file.exceptions(ios_base::badbit);
+    if (isEncodedTrack(file)) {
+        forEachLocationFromEncodedTrack(file, [&callback](const Location &location) { callback(TrackPoint(location)); });
+        return;
+    }
+    // overlap reading and parsing unless the file is small enough to be read at once; the size of non-seekable input (e.g. a
+    // pipe) is unknown so it is always pipelined
+    if (pipelined && workerThreadCount() > 1) {
+        bool large = true;
+        if (const auto start = file.tellg(); start != -1 && file.seekg(0, ios_base::end)) {
+            const auto end = file.tellg();
+            large = end == -1 || end - start > 4 * 1024 * 1024;
+            file.seekg(start);
+        }
+        file.clear();
+        if (large) {
+            forEachTrackPointPipelined(file, &trackPointFromString, callback);
+            return;
+        }
+    }
     string line;
-    vector<Location> locations;
     while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
         if (line.empty() || line.at(0) == '#')
             continue; // skip empty lines and comments
-        locations.push_back(locationFromString(line));
+        callback(trackPointFromString(line));
     }
-    return locations;
+}
+
+TrackPoint trackPointFromString(const string &line)
+{
+    // the location might be followed by a timestamp separated by white space; only look for it behind the last coordinate as
+    // white space is also allowed around the coordinates
+    const auto lastComma = line.rfind(',');
+    const auto lastCoordinate = line.find_first_not_of(" \t", lastComma == string::npos ? 0 : lastComma + 1);
+    const auto separator = lastCoordinate == string::npos ? string::npos : line.find_first_of(" \t", lastCoordinate);
+    const auto timeStart = separator == string::npos ? string::npos : line.find_first_not_of(" \t", separator);
+    if (timeStart == string::npos) {
+        return TrackPoint(locationFromString(line));
+    }
+    // refer to the line instead of copying parts of it so parsing does not allocate
+    const string_view view(line);
+    TrackPoint point(locationFromString(view.substr(0, separator)));
+    point.setTime(timeFromString(view.substr(timeStart, line.find_last_not_of(" \t") + 1 - timeStart)));
+    return point;
+}
+
+double timeFromString(string_view userInput)
+{
+    // ISO 8601 dates contain a dash after the year, otherwise the seconds since the Unix epoch are expected
+    if (userInput.find('-', 1) != string_view::npos || userInput.find('T') != string_view::npos) {
+        // DateTime needs a null-terminated string; timestamps are short enough to be copied to the stack
+        char timestamp[64];
+        if (userInput.size() >= sizeof(timestamp)) {
+            throw ParseError("The timestamp \"" % string(userInput) + "\" is too long.");
+        }
+        userInput.copy(timestamp, userInput.size());
+        timestamp[userInput.size()] = '\0';
+        return (DateTime::fromIsoStringGmt(timestamp) - DateTime::unixEpochStart()).totalSeconds();
+    }
+    return numberFromString(userInput);
 }
 
 void printAngleFormatInfo(ostream &os)
 {
     os << "To provide a location/trackpoint, use the following form:\n";
-    os << "latitude,longitude\n";
+    os << "latitude,longitude[,elevation]\n";
+    os << "The elevation is optional and specified in meters.\n";
+    os << "If you use --input-location-system ECEF, provide X,Y,Z in meters instead.\n";
+    os << "If you use --input-location-system geohash, provide a geohash with 1 to 12 characters instead.\n";
 
     os << "\nUse one of the following forms to specify angles, if you use --input-angle-measure degree:\n";
     os << "[+-]DDD.DDDDD\n";
@@ -243,12 +552,53 @@ void printAngleFormatInfo(ostream &os)
     os << "[+-]RRR.RRRRR";
 }
 
-void printConversion(const string &coordinates)
+string conversionString(const string &coordinates)
 {
-    if (coordinates.find(',') == string::npos && coordinates.find('N') == string::npos && coordinates.find('E') == string::npos)
-        cout << Angle(coordinates, inputAngularMeasure).toString(outputFormForAngles);
+    if (inputSystemForLocations != SystemForLocations::Geohash && coordinates.find(',') == string::npos
+        && coordinates.find('N') == string::npos && coordinates.find('E') == string::npos)
+        return Angle(coordinates, inputAngularMeasure).toString(outputFormForAngles);
     else
-        printLocation(locationFromString(coordinates));
+        return locationString(locationFromString(coordinates));
+}
+
+void printConversion(const string &coordinates)
+{
+    if (conversionCache) {
+        cout << conversionCache->getOrCompute(coordinates, [&coordinates] { return conversionString(coordinates); });
+    } else {
+        cout << conversionString(coordinates);
+    }
+}
+
+void printConversions(const string &filePath, bool first)
+{
+    try {
+        fstream file;
+        file.open(filePath, ios_base::in);
+        if (!file) {
+            throw std::ios_base::failure("Unable to open the file \"" % filePath + "\".");
+        }
+        file.exceptions(ios_base::badbit);
+        string line;
+        while (getline(file, line)) {
+            if (line.empty() || line.at(0) == '#')
+                continue; // skip empty lines and comments
+            if (!first) {
+                cout << '\n';
+            }
+            first = false;
+            printConversion(line);
+        }
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void printCacheStatistics(ostream &os)
+{
+    os << "Cache hit rate: parsing " << (locationCache->hitRate() * 100.0) << " % (" << locationCache->hits() << " hits, "
+       << locationCache->misses() << " misses), conversion " << (conversionCache->hitRate() * 100.0) << " % (" << conversionCache->hits()
+       << " hits, " << conversionCache->misses() << " misses)" << endl;
 }
 
 void printDistance(const std::string &locationstr1, const std::string &locationstr2)
@@ -267,7 +617,7 @@ void printDistance(double distance)
 void printTrackLength(const string &filePath, bool circle)
 {
     try {
-        vector<Location> locations(locationsFromFile(filePath));
+        LocationStorage locations(locationsFromFile(filePath));
         printDistance(Location::trackLength(locations, circle));
         cout << " (" << locations.size() << " trackpoints)";
     } catch (const std::ios_base::failure &failure) {
@@ -275,6 +625,116 @@ void printTrackLength(const string &filePath, bool circle)
     }
 }
 
+vector<string> trackFiles(const vector<const char *> &paths, const char *manifestPath)
+{
+    vector<string> files;
+    for (const char *path : paths) {
+        if (filesystem::is_directory(path)) {
+            // sort directory entries so the output order does not depend on the file system
+            const auto begin = files.size();
+            for (const auto &entry : filesystem::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file()) {
+                    files.emplace_back(entry.path().string());
+                }
+            }
+            sort(files.begin() + static_cast<vector<string>::difference_type>(begin), files.end());
+        } else {
+            files.emplace_back(path);
+        }
+    }
+    if (manifestPath) {
+        fstream manifest;
+        manifest.open(manifestPath, ios_base::in);
+        if (!manifest) {
+            throw std::ios_base::failure("Unable to open the file \"" % string(manifestPath) + "\".");
+        }
+        manifest.exceptions(ios_base::badbit);
+        string line;
+        while (getline(manifest, line)) {
+            if (line.empty() || line.at(0) == '#')
+                continue; // skip empty lines and comments
+            files.emplace_back(move(line));
+        }
+    }
+    if (files.empty()) {
+        throw ParseError("At least one track file is required.");
+    }
+    return files;
+}
+
+void printTrackLengths(const vector<const char *> &paths, const char *manifestPath, bool circle)
+{
+    vector<string> filePaths;
+    try {
+        filePaths = trackFiles(paths, manifestPath);
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+        return;
+    } catch (const filesystem::filesystem_error &error) {
+        cout << "An IO failure occurred when reading directory from provided path: " << error.what() << endl;
+        return;
+    }
+
+    struct Result {
+        double length = 0.0;
+        size_t points = 0;
+        string error;
+    };
+    vector<Result> results(filePaths.size());
+    parallelFor(filePaths.size(), [&](size_t index) {
+        Result &result = results[index];
+        try {
+            // files are already processed in parallel so do not spawn further threads per file
+            LocationStorage locations(locationsFromFile(filePaths[index], false));
+            result.length = Location::trackLength(locations, circle);
+            result.points = locations.size();
+        } catch (const std::ios_base::failure &failure) {
+            result.error = failure.what();
+        } catch (const ConversionException &) {
+            result.error = "The provided numbers couldn't be parsed correctly.";
+        } catch (const ParseError &ex) {
+            result.error = ex.what();
+        }
+    });
+
+    // print results in the order the files have been specified
+    cout.precision(12);
+    for (size_t i = 0, count = filePaths.size(); i != count; ++i) {
+        const Result &result = results[i];
+        if (result.error.empty()) {
+            cout << filePaths[i] << ',' << result.length << ',' << result.points << '\n';
+        } else {
+            cerr << "Unable to compute length of track \"" << filePaths[i] << "\": " << result.error << endl;
+        }
+    }
+}
+
+void printTrackStatistics(const string &filePath, const string &stopSpeedstr, const string &stopDurationstr)
+{
+    try {
+        TrackStatistics statistics(stringToNumber<double>(stopSpeedstr), stringToNumber<double>(stopDurationstr));
+        forEachTrackPointFromFile(filePath, [&statistics](const TrackPoint &point) { statistics.add(point); });
+        statistics.finish();
+        if (statistics.pointCount() < 2) {
+            throw ParseError("At least two locations are required to calculate a distance.");
+        }
+        cout << "Length: ";
+        printDistance(statistics.distance());
+        cout << " (" << statistics.pointCount() << " trackpoints)\n";
+        cout << "Duration: " << statistics.duration() << " s\n";
+        cout << "Average speed: " << (statistics.averageSpeed() * 3.6) << " km/h\n";
+        cout << "Maximum speed: " << (statistics.maxSpeed() * 3.6) << " km/h\n";
+        cout << "Stops: " << statistics.stops().size();
+        for (const TrackStatistics::Stop &stop : statistics.stops()) {
+            cout << "\n - ";
+            printLocation(stop.location);
+            cout << " for " << (stop.end - stop.start) << " s";
+        }
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
 void printBearing(const string &locationstr1, const string &locationstr2)
 {
     cout << locationFromString(locationstr1).initialBearingTo(locationFromString(locationstr2)).toString(outputFormForAngles) << endl;
@@ -298,39 +758,261 @@ void printDestination(const string &locationstr, const string &distancestr, cons
     printLocation(start.destination(distance, bearing));
 }
 
-void printLocation(const Location &location)
+string locationString(const Location &location)
 {
     switch (outputSystemForLocations) {
-    case SystemForLocations::LatitudeLongitude:
-        cout << location.toString(outputFormForAngles);
-        break;
     case SystemForLocations::UTMWGS84:
-        cout << location.toUtmWgs4String();
-        break;
+        return location.toUtmWgs4String();
+    case SystemForLocations::ECEF:
+        return location.toEcefString();
+    case SystemForLocations::Geohash:
+        return encodeGeohash(location, geohashPrecision);
+    default:
+        return location.toString(outputFormForAngles);
     }
 }
 
+void printLocation(const Location &location)
+{
+    cout << locationString(location);
+}
+
 void printMapsLink(const string &filePath)
 {
     try {
-        vector<Location> locations(locationsFromFile(filePath));
-        if (locations.size() > 0) {
-            cout << "https://maps.google.de/maps?saddr=";
-            const Angle::OutputForm outputForm = Angle::OutputForm::Degrees;
-            cout << locations.front().toString(outputForm);
-            if (locations.size() > 1) {
+        // write the link while reading so the track is never held in memory
+        const Angle::OutputForm outputForm = Angle::OutputForm::Degrees;
+        size_t count = 0;
+        forEachLocationFromFile(filePath, [&count, outputForm](const Location &location) {
+            switch (count++) {
+            case 0:
+                cout << "https://maps.google.de/maps?saddr=";
+                break;
+            case 1:
                 cout << "&daddr=";
-                cout << locations.at(1).toString(outputForm);
+                break;
+            default:
+                cout << "+to:";
+            }
+            cout << location.toString(outputForm);
+        });
+        if (!count) {
+            throw ParseError("At least one location is required to generate a link.");
+        }
+        cout << "&mra=mi&mrsp=2&sz=16&z=16";
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void printPolyline(const string &filePath)
+{
+    try {
+        PolylineEncoder encoder(cout);
+        forEachLocationFromFile(filePath, [&encoder](const Location &location) { encoder.add(location); });
+        encoder.flush();
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void printGeoJson(const string &filePath)
+{
+    try {
+        GeoJsonLineStringWriter writer(cout);
+        forEachLocationFromFile(filePath, [&writer](const Location &location) { writer.add(location); });
+        writer.finish();
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void printResampledTrack(const string &filePath, const string &spacingstr)
+{
+    const double spacing = stringToNumber<double>(spacingstr);
+    if (!(spacing > 0.0)) {
+        throw ParseError("The distance for resampling must be greater than zero.");
+    }
+    try {
+        // walk the track keeping only the previous trackpoint and the distance left until the next sample; samples are computed
+        // in batches of fixed size so memory usage does not depend on the length of a segment
+        constexpr size_t batchSize = 256;
+        double fractions[batchSize], latitudes[batchSize], longitudes[batchSize];
+        Location previous;
+        bool first = true;
+        double remaining = 0.0;
+        forEachLocationFromFile(filePath, [&](const Location &location) {
+            if (first) {
+                first = false;
+                printLocation(location);
+                cout << '\n';
+                remaining = spacing;
+                previous = location;
+                return;
             }
-            if (locations.size() > 2) {
-                for (vector<Location>::const_iterator i = locations.cbegin() + 2, end = locations.cend(); i != end; ++i) {
-                    cout << "+to:";
-                    cout << i->toString(outputForm);
+            const double segmentLength = previous.distanceTo(location);
+            double offset = remaining;
+            while (offset <= segmentLength) {
+                size_t count = 0;
+                for (; count != batchSize && offset <= segmentLength; offset += spacing) {
+                    fractions[count++] = offset / segmentLength;
+                }
+                Location::intermediatePoints(previous, location, fractions, count, latitudes, longitudes);
+                for (size_t i = 0; i != count; ++i) {
+                    printLocation(Location(Angle(latitudes[i]), Angle(longitudes[i])));
+                    cout << '\n';
                 }
             }
-            cout << "&mra=mi&mrsp=2&sz=16&z=16";
-        } else {
-            throw ParseError("At least one location is required to generate a link.");
+            remaining = offset - segmentLength;
+            previous = location;
+        });
+        if (first) {
+            throw ParseError("At least one location is required to resample a track.");
+        }
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void encodeTrack(const string &inputPath, const string &outputPath, bool withElevation)
+{
+    try {
+        fstream output;
+        output.exceptions(ios_base::failbit | ios_base::badbit);
+        output.open(outputPath, ios_base::out | ios_base::trunc | ios_base::binary);
+        TrackEncoder encoder(output, withElevation);
+        forEachLocationFromFile(inputPath, [&encoder](const Location &location) { encoder.add(location); });
+        encoder.flush();
+        output.flush();
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading/writing file from/to provided path: " << failure.what() << endl;
+    }
+}
+
+void decodeTrack(const string &inputPath, const string &outputPath)
+{
+    try {
+        fstream input;
+        input.open(inputPath, ios_base::in | ios_base::binary);
+        if (!input) {
+            throw std::ios_base::failure("Unable to open the file \"" % inputPath + "\".");
+        }
+        input.exceptions(ios_base::badbit);
+        fstream output;
+        output.exceptions(ios_base::failbit | ios_base::badbit);
+        output.open(outputPath, ios_base::out | ios_base::trunc);
+        // print the elevation in centimeter precision as stored so the output can be encoded again without loss
+        TrackDecoder decoder(input);
+        vector<Location> locations;
+        output << fixed << setprecision(2);
+        while (decoder.decodeBlock(locations)) {
+            for (const Location &location : locations) {
+                output << FixedLocation(location).toString();
+                if (decoder.hasElevation()) {
+                    output << ',' << location.elevation();
+                }
+                output << '\n';
+            }
+        }
+        output.flush();
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading/writing file from/to provided path: " << failure.what() << endl;
+    }
+}
+
+void printSpatiallySorted(const string &filePath, const char *permutationPath)
+{
+    try {
+        LocationStorage locations(locationsFromFile(filePath));
+        const vector<size_t> order(spatialOrder(locations));
+        for (size_t index : order) {
+            printLocation(locations[index]);
+            cout << '\n';
+        }
+        if (permutationPath) {
+            fstream permutation;
+            permutation.exceptions(ios_base::failbit | ios_base::badbit);
+            permutation.open(permutationPath, ios_base::out | ios_base::trunc);
+            for (size_t index : order) {
+                permutation << index << '\n';
+            }
+            permutation.flush();
+        }
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading/writing file from/to provided path: " << failure.what() << endl;
+    }
+}
+
+void printSnappedLocations(const string &routeFilePath, const string &filePath)
+{
+    try {
+        const RouteIndex index(locationsFromFile(routeFilePath));
+        forEachLocationFromFile(filePath, [&index](const Location &location) {
+            const RouteIndex::SnapResult result(index.snap(location));
+            printLocation(result.location);
+            cout << ',' << result.segmentIndex << ',' << result.offset << ',' << result.distance << '\n';
+        });
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void printClusters(const string &filePath, const string &epsstr, const string &minPointsstr)
+{
+    const double eps = stringToNumber<double>(epsstr);
+    const size_t minPoints = stringToNumber<size_t>(minPointsstr);
+    if (!(eps > 0.0) || !minPoints) {
+        throw ParseError("The distance and the minimum number of points for clustering must be greater than zero.");
+    }
+    if (eps < 1e-6) {
+        // smaller distances are below the precision of the coordinates and would overflow the cell coordinates
+        throw ParseError("The distance for clustering must be at least one micrometer.");
+    }
+    try {
+        LocationStorage locations(locationsFromFile(filePath));
+        const vector<int64_t> clusterIds(dbscan(locations, eps, minPoints));
+        for (size_t i = 0, count = locations.size(); i != count; ++i) {
+            printLocation(locations[i]);
+            cout << ',' << clusterIds[i] << '\n';
+        }
+    } catch (const std::ios_base::failure &failure) {
+        cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
+    }
+}
+
+void printGeohashBuckets(const string &filePath, const string &precisionstr)
+{
+    const auto precision = stringToNumber<unsigned int>(precisionstr);
+    if (precision < 1 || precision > 12) {
+        throw ParseError("The geohash precision must be between 1 and 12.");
+    }
+    try {
+        LocationStorage locations(locationsFromFile(filePath));
+        const size_t count = locations.size();
+
+        // compute the hashes in batches over separate coordinate arrays
+        vector<double> latitudes(count), longitudes(count);
+        size_t i = 0;
+        for (const Location &location : locations) {
+            Angle longitude(location.longitude());
+            longitude.adjust180To180();
+            latitudes[i] = location.latitude().degreeValue();
+            longitudes[i++] = longitude.degreeValue();
+        }
+        vector<uint64_t> hashes(count);
+        geohashBits(latitudes.data(), longitudes.data(), hashes.data(), count);
+
+        // sort by prefix keeping the original order within each bucket
+        const unsigned int shift = 64 - 5 * precision;
+        vector<pair<uint64_t, size_t>> buckets(count);
+        for (i = 0; i != count; ++i) {
+            buckets[i] = make_pair(hashes[i] >> shift, i);
+        }
+        sort(buckets.begin(), buckets.end());
+        for (const auto &bucket : buckets) {
+            cout << geohashString(bucket.first << shift, precision) << ',';
+            printLocation(locations[bucket.second]);
+            cout << '\n';
         }
     } catch (const std::ios_base::failure &failure) {
         cout << "An IO failure occurred when reading file from provided path: " << failure.what() << endl;
@@ -3,32 +3,63 @@
 
 #include "./angle.h"
 #include "./location.h"
+#include "./locationstorage.h"
+#include "./memocache.h"
+#include "./trackpoint.h"
 
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-enum class SystemForLocations { LatitudeLongitude, UTMWGS84 };
+enum class SystemForLocations { LatitudeLongitude, UTMWGS84, ECEF, Geohash };
 
 extern Angle::AngularMeasure inputAngularMeasure;
 extern Angle::OutputForm outputFormForAngles;
 extern SystemForLocations inputSystemForLocations;
 extern SystemForLocations outputSystemForLocations;
+extern unsigned int geohashPrecision;
+extern bool useHugePagesForLocations;
+extern std::unique_ptr<MemoCache<Location>> locationCache;
+extern std::unique_ptr<MemoCache<std::string>> conversionCache;
 
 int main(int argc, char *argv[]);
 
-Location locationFromString(const std::string &userInput);
-std::vector<Location> locationsFromFile(const std::string &path);
+Location locationFromString(std::string_view userInput);
+Location parseLocation(std::string_view userInput);
+LocationStorage locationsFromFile(const std::string &path, bool pipelined = true);
+void forEachLocationFromFile(const std::string &path, const std::function<void(const Location &)> &callback, bool pipelined = true);
+void forEachTrackPointFromFile(const std::string &path, const std::function<void(const TrackPoint &)> &callback, bool pipelined = true);
+TrackPoint trackPointFromString(const std::string &line);
+double timeFromString(std::string_view userInput);
 void printAngleFormatInfo(std::ostream &os);
+std::string conversionString(const std::string &coordinates);
 void printConversion(const std::string &coordinates);
+void printConversions(const std::string &filePath, bool first = true);
+void printCacheStatistics(std::ostream &os);
 void printDistance(const std::string &locationstr1, const std::string &locationstr2);
 void printDistance(double distance);
 void printTrackLength(const std::string &filePath, bool circle = false);
+std::vector<std::string> trackFiles(const std::vector<const char *> &paths, const char *manifestPath = nullptr);
+void printTrackLengths(const std::vector<const char *> &paths, const char *manifestPath = nullptr, bool circle = false);
+void printTrackStatistics(const std::string &filePath, const std::string &stopSpeedstr, const std::string &stopDurationstr);
 void printBearing(const std::string &locationstr1, const std::string &locationstr2);
 void printFinalBearing(const std::string &locationstr1, const std::string &locationstr2);
 void printMidpoint(const std::string &locationstr1, const std::string &locationstr2);
 void printDestination(const std::string &locationstr, const std::string &distancestr, const std::string &bearingstr);
+std::string locationString(const Location &location);
 void printLocation(const Location &location);
 void printMapsLink(const std::string &filePath);
+void printPolyline(const std::string &filePath);
+void printGeoJson(const std::string &filePath);
+void encodeTrack(const std::string &inputPath, const std::string &outputPath, bool withElevation = false);
+void decodeTrack(const std::string &inputPath, const std::string &outputPath);
+void printSpatiallySorted(const std::string &filePath, const char *permutationPath = nullptr);
+void printSnappedLocations(const std::string &routeFilePath, const std::string &filePath);
+void printClusters(const std::string &filePath, const std::string &epsstr, const std::string &minPointsstr);
+void printGeohashBuckets(const std::string &filePath, const std::string &precisionstr);
+void printResampledTrack(const std::string &filePath, const std::string &spacingstr);
 
 #endif // MAIN_H_INCLUDED
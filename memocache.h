@@ -0,0 +1,122 @@
+#ifndef MEMOCACHE_H
+#define MEMOCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// bounded cache mapping raw input strings to computed values; entries are distributed over independently locked shards which
+// evict their least recently used entry when full so the cache can be used from multiple threads without contending on one lock
+template <typename Value> class MemoCache {
+public:
+    explicit MemoCache(std::size_t capacity, std::size_t shardCount = 16);
+
+    bool get(const std::string &key, Value &value);
+    void put(const std::string &key, const Value &value);
+    template <typename Compute> Value getOrCompute(const std::string &key, Compute compute);
+    std::size_t hits() const;
+    std::size_t misses() const;
+    double hitRate() const;
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::list<std::pair<std::string, Value>> entries;
+        std::unordered_map<std::string, typename std::list<std::pair<std::string, Value>>::iterator> index;
+    };
+
+    Shard &shardFor(const std::string &key);
+
+    std::unique_ptr<Shard[]> m_shards;
+    std::size_t m_shardCount;
+    std::size_t m_shardCapacity;
+    std::atomic<std::size_t> m_hits;
+    std::atomic<std::size_t> m_misses;
+};
+
+template <typename Value>
+MemoCache<Value>::MemoCache(std::size_t capacity, std::size_t shardCount)
+    : m_shards(new Shard[shardCount ? shardCount : 1])
+    , m_shardCount(shardCount ? shardCount : 1)
+    , m_shardCapacity((capacity + m_shardCount - 1) / m_shardCount)
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+template <typename Value> typename MemoCache<Value>::Shard &MemoCache<Value>::shardFor(const std::string &key)
+{
+    return m_shards[std::hash<std::string>()(key) % m_shardCount];
+}
+
+template <typename Value> bool MemoCache<Value>::get(const std::string &key, Value &value)
+{
+    Shard &shard = shardFor(key);
+    {
+        const std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto entry = shard.index.find(key);
+        if (entry != shard.index.end()) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, entry->second);
+            value = entry->second->second;
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+template <typename Value> void MemoCache<Value>::put(const std::string &key, const Value &value)
+{
+    if (!m_shardCapacity) {
+        return;
+    }
+    Shard &shard = shardFor(key);
+    const std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto entry = shard.index.find(key);
+    if (entry != shard.index.end()) {
+        entry->second->second = value;
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry->second);
+        return;
+    }
+    if (shard.entries.size() >= m_shardCapacity) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+    }
+    shard.entries.emplace_front(key, value);
+    shard.index.emplace(key, shard.entries.begin());
+}
+
+template <typename Value> template <typename Compute> Value MemoCache<Value>::getOrCompute(const std::string &key, Compute compute)
+{
+    Value value;
+    if (!get(key, value)) {
+        value = compute();
+        put(key, value);
+    }
+    return value;
+}
+
+template <typename Value> std::size_t MemoCache<Value>::hits() const
+{
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+template <typename Value> std::size_t MemoCache<Value>::misses() const
+{
+    return m_misses.load(std::memory_order_relaxed);
+}
+
+template <typename Value> double MemoCache<Value>::hitRate() const
+{
+    const std::size_t total = hits() + misses();
+    return total ? static_cast<double>(hits()) / static_cast<double>(total) : 0.0;
+}
+
+#endif // MEMOCACHE_H
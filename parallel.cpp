@@ -0,0 +1,73 @@
+#include "./parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+unsigned int workerThreadCount()
+{
+    const unsigned int count = thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+void parallelFor(size_t count, const function<void(size_t index)> &task, unsigned int threadCount)
+{
+    if (!threadCount) {
+        threadCount = workerThreadCount();
+    }
+    if (threadCount > count) {
+        threadCount = static_cast<unsigned int>(count);
+    }
+    if (threadCount <= 1) {
+        for (size_t i = 0; i != count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // hand out one index at a time so threads which got cheap tasks simply take the next one; this balances very uneven
+    // task sizes as well as per-thread deques with stealing would as the tasks are independent
+    atomic<size_t> next(0);
+    exception_ptr error;
+    mutex errorMutex;
+    const auto work = [&] {
+        for (size_t i; (i = next.fetch_add(1, memory_order_relaxed)) < count;) {
+            try {
+                task(i);
+            } catch (...) {
+                const lock_guard<mutex> lock(errorMutex);
+                if (!error) {
+                    error = current_exception();
+                }
+                next.store(count, memory_order_relaxed);
+            }
+        }
+    };
+    vector<thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int i = 1; i != threadCount; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (thread &t : threads) {
+        t.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+void parallelForChunks(size_t count, size_t chunkSize, const function<void(size_t begin, size_t end)> &task, unsigned int threadCount)
+{
+    if (!chunkSize) {
+        chunkSize = 1;
+    }
+    const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+    parallelFor(
+        chunkCount, [&](size_t chunk) { task(chunk * chunkSize, min(count, (chunk + 1) * chunkSize)); }, threadCount);
+}
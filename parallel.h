@@ -0,0 +1,12 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+unsigned int workerThreadCount();
+void parallelFor(std::size_t count, const std::function<void(std::size_t index)> &task, unsigned int threadCount = 0);
+void parallelForChunks(std::size_t count, std::size_t chunkSize, const std::function<void(std::size_t begin, std::size_t end)> &task,
+    unsigned int threadCount = 0);
+
+#endif // PARALLEL_H
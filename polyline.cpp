@@ -0,0 +1,90 @@
+#include "./polyline.h"
+
+#include <cmath>
+#include <ostream>
+
+using namespace std;
+
+// flush the output only every few kilobytes instead of writing each character
+#define POLYLINE_BUFFER_SIZE 8192
+
+PolylineEncoder::PolylineEncoder(ostream &stream, unsigned int precision)
+    : m_stream(stream)
+    , m_factor(pow(10.0, precision))
+    , m_previousLat(0)
+    , m_previousLon(0)
+{
+    m_buffer.reserve(POLYLINE_BUFFER_SIZE + 32);
+}
+
+void PolylineEncoder::add(const Location &location)
+{
+    const auto lat = static_cast<int64_t>(llround(location.latitude().degreeValue() * m_factor));
+    const auto lon = static_cast<int64_t>(llround(location.longitude().degreeValue() * m_factor));
+    appendValue(lat - m_previousLat);
+    appendValue(lon - m_previousLon);
+    m_previousLat = lat;
+    m_previousLon = lon;
+    if (m_buffer.size() >= POLYLINE_BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void PolylineEncoder::flush()
+{
+    m_stream.write(m_buffer.data(), static_cast<streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+void PolylineEncoder::appendValue(int64_t value)
+{
+    // see https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+    auto bits = static_cast<uint64_t>(value) << 1;
+    if (value < 0) {
+        bits = ~bits;
+    }
+    while (bits >= 0x20) {
+        m_buffer.push_back(static_cast<char>((0x20 | (bits & 0x1F)) + 63));
+        bits >>= 5;
+    }
+    m_buffer.push_back(static_cast<char>(bits + 63));
+}
+
+GeoJsonLineStringWriter::GeoJsonLineStringWriter(ostream &stream)
+    : m_stream(stream)
+    , m_previousPrecision(stream.precision(7))
+    , m_previousFlags(stream.setf(ios_base::fixed, ios_base::floatfield))
+    , m_first(true)
+    , m_finished(false)
+{
+    m_stream << "{\"type\":\"LineString\",\"coordinates\":[";
+}
+
+GeoJsonLineStringWriter::~GeoJsonLineStringWriter()
+{
+    // only restore the formatting; closing the object is left to finish() so an aborted output is not made to look complete
+    if (!m_finished) {
+        m_stream.precision(m_previousPrecision);
+        m_stream.flags(m_previousFlags);
+    }
+}
+
+void GeoJsonLineStringWriter::add(const Location &location)
+{
+    if (!m_first) {
+        m_stream << ',';
+    }
+    m_first = false;
+    // GeoJSON positions are longitude first
+    m_stream << '[' << location.longitude().degreeValue() << ',' << location.latitude().degreeValue() << ']';
+}
+
+void GeoJsonLineStringWriter::finish()
+{
+    if (!m_finished) {
+        m_finished = true;
+        m_stream << "]}";
+        m_stream.precision(m_previousPrecision);
+        m_stream.flags(m_previousFlags);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef POLYLINE_H
+#define POLYLINE_H
+
+#include "./location.h"
+
+#include <cstdint>
+#include <ios>
+#include <string>
+
+class PolylineEncoder {
+public:
+    explicit PolylineEncoder(std::ostream &stream, unsigned int precision = 5);
+
+    void add(const Location &location);
+    void flush();
+
+private:
+    void appendValue(std::int64_t value);
+
+    std::ostream &m_stream;
+    std::string m_buffer;
+    double m_factor;
+    std::int64_t m_previousLat;
+    std::int64_t m_previousLon;
+};
+
+class GeoJsonLineStringWriter {
+public:
+    explicit GeoJsonLineStringWriter(std::ostream &stream);
+    ~GeoJsonLineStringWriter();
+
+    void add(const Location &location);
+    void finish();
+
+private:
+    std::ostream &m_stream;
+    std::streamsize m_previousPrecision;
+    std::ios_base::fmtflags m_previousFlags;
+    bool m_first;
+    bool m_finished;
+};
+
+#endif // POLYLINE_H
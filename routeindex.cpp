@@ -0,0 +1,243 @@
+#include "./routeindex.h"
+
+#include <c++utilities/misc/parseerror.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265359
+#endif
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace {
+
+template <typename Vector> inline double dot(const Vector &a, const Vector &b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <typename Vector> inline Vector cross(const Vector &a, const Vector &b)
+{
+    return Vector{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+template <typename Vector> inline Vector normalized(const Vector &a)
+{
+    const double length = sqrt(dot(a, a));
+    return Vector{ a.x / length, a.y / length, a.z / length };
+}
+
+template <typename Vector> inline Vector toVector(const Location &location)
+{
+    const double lat = location.latitude().radianValue(), lon = location.longitude().radianValue();
+    return Vector{ cos(lat) * cos(lon), cos(lat) * sin(lon), sin(lat) };
+}
+
+template <typename Vector> inline Location toLocation(const Vector &v)
+{
+    return Location(Angle(atan2(v.z, sqrt(v.x * v.x + v.y * v.y))), Angle(atan2(v.y, v.x)));
+}
+
+template <typename Vector> inline double angleBetween(const Vector &a, const Vector &b)
+{
+    // more accurate than acos() for small angles
+    const Vector c = cross(a, b);
+    return atan2(sqrt(dot(c, c)), dot(a, b));
+}
+
+template <typename Vector> inline Vector slerp(const Vector &a, const Vector &b, double angle, double fraction)
+{
+    const double sinAngle = sin(angle), factorA = sin((1.0 - fraction) * angle) / sinAngle, factorB = sin(fraction * angle) / sinAngle;
+    return Vector{ factorA * a.x + factorB * b.x, factorA * a.y + factorB * b.y, factorA * a.z + factorB * b.z };
+}
+
+/// \brief Calls \a callback for every cell crossed by the straight line between the specified points given in units of cells.
+template <typename Callback> void forEachCellOnLine(double y0, double x0, double y1, double x1, Callback callback)
+{
+    auto y = static_cast<int64_t>(floor(y0)), x = static_cast<int64_t>(floor(x0));
+    const auto endY = static_cast<int64_t>(floor(y1)), endX = static_cast<int64_t>(floor(x1));
+    const double dy = fabs(y1 - y0), dx = fabs(x1 - x0);
+    const int64_t stepY = y1 > y0 ? 1 : -1, stepX = x1 > x0 ? 1 : -1;
+    // parameters along the line at which the next horizontal/vertical cell border is reached
+    const double infinity = numeric_limits<double>::infinity();
+    double nextY = dy > 0.0 ? (stepY > 0 ? static_cast<double>(y + 1) - y0 : y0 - static_cast<double>(y)) / dy : infinity;
+    double nextX = dx > 0.0 ? (stepX > 0 ? static_cast<double>(x + 1) - x0 : x0 - static_cast<double>(x)) / dx : infinity;
+    const double deltaY = dy > 0.0 ? 1.0 / dy : infinity, deltaX = dx > 0.0 ? 1.0 / dx : infinity;
+    callback(y, x);
+    for (auto remaining = std::abs(endY - y) + std::abs(endX - x); remaining > 0; --remaining) {
+        if (nextY < nextX ? y != endY : x == endX) {
+            nextY += deltaY;
+            y += stepY;
+        } else {
+            nextX += deltaX;
+            x += stepX;
+        }
+        callback(y, x);
+    }
+}
+
+} // namespace
+
+RouteIndex::RouteIndex(const LocationStorage &route)
+    : m_cellSize(0.0)
+    , m_minLatCell(numeric_limits<int64_t>::max())
+    , m_maxLatCell(numeric_limits<int64_t>::min())
+    , m_minLonCell(numeric_limits<int64_t>::max())
+    , m_maxLonCell(numeric_limits<int64_t>::min())
+{
+    if (route.size() < 2) {
+        throw ParseError("At least two locations are required to define a route.");
+    }
+    if (route.size() - 1 > numeric_limits<uint32_t>::max()) {
+        throw ParseError("The route has too many locations.");
+    }
+
+    // precompute unit vectors and normals of the great circles so queries only need dot and cross products
+    m_segments.reserve(route.size() - 1);
+    vector<double> extents;
+    extents.reserve(route.size() - 1);
+    for (size_t i = 1, count = route.size(); i != count; ++i) {
+        Segment segment;
+        segment.start = toVector<Vector>(route[i - 1]);
+        segment.end = toVector<Vector>(route[i]);
+        const Vector normal = cross(segment.start, segment.end);
+        segment.normal = dot(normal, normal) > 0.0 ? normalized(normal) : Vector{ 0.0, 0.0, 0.0 };
+        m_segments.push_back(segment);
+        extents.push_back(max(fabs(route[i].latitude().degreeValue() - route[i - 1].latitude().degreeValue()),
+            fabs(route[i].longitude().degreeValue() - route[i - 1].longitude().degreeValue())));
+    }
+
+    // use cells about twice as large as a typical segment so most segments cover only a few cells but not smaller than about
+    // 50 m so typical GPS noise does not require searching many rings of cells; the median is not skewed by a few long gaps
+    const auto median = extents.begin() + static_cast<ptrdiff_t>(extents.size() / 2);
+    nth_element(extents.begin(), median, extents.end());
+    m_cellSize = max(2.0 * *median, 5e-4);
+
+    // collect the segments of each cell crossed by the segment in a flat array; the great circle is followed in steps of
+    // at most one cell so the number of entries only grows linearly with the length of a segment
+    vector<pair<uint64_t, uint32_t>> entries;
+    entries.reserve(m_segments.size() * 2);
+    const auto addEntry = [this, &entries](int64_t latCell, int64_t lonCell, uint32_t segmentIndex) {
+        m_minLatCell = min(m_minLatCell, latCell);
+        m_maxLatCell = max(m_maxLatCell, latCell);
+        m_minLonCell = min(m_minLonCell, lonCell);
+        m_maxLonCell = max(m_maxLonCell, lonCell);
+        entries.emplace_back(cellKey(latCell, lonCell), segmentIndex);
+    };
+    for (size_t i = 0, count = m_segments.size(); i != count; ++i) {
+        const Segment &segment = m_segments[i];
+        const auto segmentIndex = static_cast<uint32_t>(i);
+        const double angle = angleBetween(segment.start, segment.end);
+        const auto steps = max(static_cast<size_t>(ceil(angle * 180.0 / M_PI / m_cellSize)), static_cast<size_t>(1));
+        Location previous = route[i];
+        for (size_t step = 1; step <= steps; ++step) {
+            const Location next = step == steps
+                ? route[i + 1]
+                : toLocation(slerp(segment.start, segment.end, angle, static_cast<double>(step) / static_cast<double>(steps)));
+            const double lat0 = previous.latitude().degreeValue(), lon0 = previous.longitude().degreeValue();
+            const double lat1 = next.latitude().degreeValue(), lon1 = next.longitude().degreeValue();
+            if (fabs(lon1 - lon0) > 180.0) {
+                // the step crosses the antimeridian so the cells of both ends are adjacent
+                addEntry(cellCoordinate(lat0), cellCoordinate(lon0), segmentIndex);
+                addEntry(cellCoordinate(lat1), cellCoordinate(lon1), segmentIndex);
+            } else {
+                forEachCellOnLine(lat0 / m_cellSize, lon0 / m_cellSize, lat1 / m_cellSize, lon1 / m_cellSize,
+                    [&](int64_t latCell, int64_t lonCell) { addEntry(latCell, lonCell, segmentIndex); });
+            }
+            previous = next;
+        }
+    }
+    sort(entries.begin(), entries.end());
+    entries.erase(unique(entries.begin(), entries.end()), entries.end());
+    m_cellSegments.reserve(entries.size());
+    for (size_t i = 0, count = entries.size(); i != count;) {
+        const uint64_t key = entries[i].first;
+        const auto begin = static_cast<uint32_t>(m_cellSegments.size());
+        for (; i != count && entries[i].first == key; ++i) {
+            m_cellSegments.push_back(entries[i].second);
+        }
+        m_cells.emplace(key, make_pair(begin, static_cast<uint32_t>(m_cellSegments.size())));
+    }
+}
+
+int64_t RouteIndex::cellCoordinate(double degrees) const
+{
+    return static_cast<int64_t>(floor(degrees / m_cellSize));
+}
+
+uint64_t RouteIndex::cellKey(int64_t latCell, int64_t lonCell)
+{
+    return (static_cast<uint64_t>(latCell) << 32) ^ static_cast<uint32_t>(lonCell);
+}
+
+bool RouteIndex::snapToSegment(size_t segmentIndex, const Vector &point, SnapResult &result) const
+{
+    const Segment &segment = m_segments[segmentIndex];
+    // project the point onto the great circle of the segment and check whether the projection lies between its end points
+    Vector closest = segment.start;
+    const double distanceToPlane = dot(point, segment.normal);
+    const Vector projected = { point.x - distanceToPlane * segment.normal.x, point.y - distanceToPlane * segment.normal.y,
+        point.z - distanceToPlane * segment.normal.z };
+    // segments of zero length have no great circle so only the end points are considered
+    if (dot(segment.normal, segment.normal) > 0.0 && dot(projected, projected) > 0.0
+        && dot(cross(segment.start, projected), segment.normal) >= 0.0 && dot(cross(projected, segment.end), segment.normal) >= 0.0) {
+        closest = normalized(projected);
+    } else if (dot(point, segment.end) > dot(point, segment.start)) {
+        closest = segment.end;
+    }
+    const double distance = angleBetween(point, closest) * Location::earthRadius();
+    if (distance >= result.distance) {
+        return false;
+    }
+    result.location = toLocation(closest);
+    result.segmentIndex = segmentIndex;
+    result.offset = angleBetween(segment.start, closest) * Location::earthRadius();
+    result.distance = distance;
+    return true;
+}
+
+RouteIndex::SnapResult RouteIndex::snap(const Location &location) const
+{
+    SnapResult result;
+    result.distance = numeric_limits<double>::infinity();
+    const Vector point = toVector<Vector>(location);
+    const double lat = location.latitude().degreeValue();
+    const auto latCell = cellCoordinate(lat);
+    const auto lonCell = cellCoordinate(location.longitude().degreeValue());
+
+    // check rings of cells around the cell of the location until no closer segment can be found in the next ring
+    const auto maxRing
+        = max({ latCell - m_minLatCell, m_maxLatCell - latCell, lonCell - m_minLonCell, m_maxLonCell - lonCell, static_cast<int64_t>(0) });
+    const double cellSizeInMeters = m_cellSize * M_PI / 180.0 * Location::earthRadius();
+    for (int64_t ring = 0; ring <= maxRing; ++ring) {
+        // fall back to checking all segments when the location is so far away from the route that most cells would be empty
+        if (static_cast<double>(ring) * static_cast<double>(ring) > static_cast<double>(m_segments.size())) {
+            for (size_t k = 0, count = m_segments.size(); k != count; ++k) {
+                snapToSegment(k, point, result);
+            }
+            break;
+        }
+        for (auto i = latCell - ring; i <= latCell + ring; ++i) {
+            const auto step = (i == latCell - ring || i == latCell + ring) ? 1 : 2 * ring;
+            for (auto j = lonCell - ring; j <= lonCell + ring; j += step ? step : 1) {
+                const auto cell = m_cells.find(cellKey(i, j));
+                if (cell == m_cells.end()) {
+                    continue;
+                }
+                for (auto k = cell->second.first; k != cell->second.second; ++k) {
+                    snapToSegment(m_cellSegments[k], point, result);
+                }
+            }
+        }
+        // cells of the next ring are at least "ring" cells away; longitudes converge towards the poles
+        const double maxLat = min(fabs(lat) + static_cast<double>(ring + 2) * m_cellSize, 90.0);
+        if (result.distance <= static_cast<double>(ring) * cellSizeInMeters * cos(maxLat * M_PI / 180.0)) {
+            break;
+        }
+    }
+    return result;
+}
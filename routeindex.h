@@ -0,0 +1,53 @@
+#ifndef ROUTEINDEX_H
+#define ROUTEINDEX_H
+
+#include "./location.h"
+#include "./locationstorage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class RouteIndex {
+public:
+    struct SnapResult {
+        Location location;
+        std::size_t segmentIndex = 0;
+        double offset = 0.0;
+        double distance = 0.0;
+    };
+
+    explicit RouteIndex(const LocationStorage &route);
+
+    std::size_t segmentCount() const;
+    SnapResult snap(const Location &location) const;
+
+private:
+    struct Vector {
+        double x, y, z;
+    };
+    struct Segment {
+        Vector start;
+        Vector end;
+        Vector normal;
+    };
+
+    std::int64_t cellCoordinate(double degrees) const;
+    static std::uint64_t cellKey(std::int64_t latCell, std::int64_t lonCell);
+    bool snapToSegment(std::size_t segmentIndex, const Vector &point, SnapResult &result) const;
+
+    std::vector<Segment> m_segments;
+    std::vector<std::uint32_t> m_cellSegments;
+    std::unordered_map<std::uint64_t, std::pair<std::uint32_t, std::uint32_t>> m_cells;
+    double m_cellSize;
+    std::int64_t m_minLatCell, m_maxLatCell, m_minLonCell, m_maxLonCell;
+};
+
+inline std::size_t RouteIndex::segmentCount() const
+{
+    return m_segments.size();
+}
+
+#endif // ROUTEINDEX_H
@@ -0,0 +1,123 @@
+#include "./spatialsort.h"
+#include "./parallel.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+struct KeyedIndex {
+    uint64_t key;
+    size_t index;
+};
+
+// splits the range [0, size) into one slice per thread, large enough to amortize the scheduling
+template <typename Function> void forEachSlice(size_t size, Function function)
+{
+    const size_t sliceCount = min<size_t>(workerThreadCount(), max<size_t>(size / 65536, 1));
+    const size_t sliceSize = (size + sliceCount - 1) / sliceCount;
+    parallelFor(sliceCount, [&](size_t slice) { function(slice, slice * sliceSize, min(size, (slice + 1) * sliceSize)); });
+}
+
+void radixSort(vector<KeyedIndex> &items)
+{
+    // least significant digit first with 8 bit digits; each thread counts and scatters its own slice of the input
+    constexpr size_t digitCount = 256;
+    const size_t size = items.size();
+    const size_t sliceCount = min<size_t>(workerThreadCount(), max<size_t>(size / 65536, 1));
+    vector<KeyedIndex> buffer(size);
+    vector<size_t> offsets(sliceCount * digitCount);
+    for (unsigned int shift = 0; shift < 64; shift += 8) {
+        fill(offsets.begin(), offsets.end(), 0);
+        forEachSlice(size, [&](size_t slice, size_t begin, size_t end) {
+            size_t *const counts = &offsets[slice * digitCount];
+            for (size_t i = begin; i != end; ++i) {
+                ++counts[(items[i].key >> shift) & 0xFF];
+            }
+        });
+        // turn the counts into start offsets ordered by digit and then by slice to keep the sort stable
+        size_t total = 0;
+        bool singleDigit = false;
+        for (size_t digit = 0; digit != digitCount; ++digit) {
+            const size_t digitStart = total;
+            for (size_t slice = 0; slice != sliceCount; ++slice) {
+                size_t &offset = offsets[slice * digitCount + digit];
+                const size_t count = offset;
+                offset = total;
+                total += count;
+            }
+            singleDigit = singleDigit || total - digitStart == size;
+        }
+        if (singleDigit) {
+            continue; // all keys share this digit so the pass would not change the order
+        }
+        forEachSlice(size, [&](size_t slice, size_t begin, size_t end) {
+            size_t *const slotOffsets = &offsets[slice * digitCount];
+            for (size_t i = begin; i != end; ++i) {
+                buffer[slotOffsets[(items[i].key >> shift) & 0xFF]++] = items[i];
+            }
+        });
+        items.swap(buffer);
+    }
+}
+
+template <typename Locations> vector<size_t> computeSpatialOrder(const Locations &locations)
+{
+    vector<KeyedIndex> items(locations.size());
+    forEachSlice(locations.size(), [&](size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i != end; ++i) {
+            items[i] = KeyedIndex{ hilbertKey(locations[i]), i };
+        }
+    });
+    if (!items.empty()) {
+        radixSort(items);
+    }
+    vector<size_t> order;
+    order.reserve(items.size());
+    for (const KeyedIndex &item : items) {
+        order.push_back(item.index);
+    }
+    return order;
+}
+
+} // namespace
+
+uint64_t hilbertKey(const Location &location)
+{
+    // map latitude and longitude onto a 2^32 x 2^32 grid and compute the distance along the Hilbert curve
+    const double lat = min(max(location.latitude().degreeValue(), -90.0), 90.0);
+    double lon = fmod(location.longitude().degreeValue() + 180.0, 360.0);
+    if (lon < 0.0) {
+        lon += 360.0;
+    }
+    constexpr double cells = 4294967295.0;
+    auto x = static_cast<uint32_t>(lon / 360.0 * cells);
+    auto y = static_cast<uint32_t>((lat + 90.0) / 180.0 * cells);
+    uint64_t key = 0;
+    for (uint32_t s = 1u << 31; s; s >>= 1) {
+        const uint32_t rx = (x & s) ? 1 : 0;
+        const uint32_t ry = (y & s) ? 1 : 0;
+        key += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        // rotate the quadrant so the curve stays continuous
+        if (!ry) {
+            if (rx) {
+                x = ~x;
+                y = ~y;
+            }
+            swap(x, y);
+        }
+    }
+    return key;
+}
+
+vector<size_t> spatialOrder(const vector<Location> &locations)
+{
+    return computeSpatialOrder(locations);
+}
+
+vector<size_t> spatialOrder(const LocationStorage &locations)
+{
+    return computeSpatialOrder(locations);
+}
@@ -0,0 +1,15 @@
+#ifndef SPATIALSORT_H
+#define SPATIALSORT_H
+
+#include "./location.h"
+#include "./locationstorage.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+std::uint64_t hilbertKey(const Location &location);
+std::vector<std::size_t> spatialOrder(const std::vector<Location> &locations);
+std::vector<std::size_t> spatialOrder(const LocationStorage &locations);
+
+#endif // SPATIALSORT_H
@@ -0,0 +1,209 @@
+#include "./trackcodec.h"
+#include "./fixedlocation.h"
+
+#include <c++utilities/misc/parseerror.h>
+
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+using namespace std;
+using namespace CppUtilities;
+
+// Encoded tracks start with a header (magic followed by a flags byte) followed by independent blocks. Each block consists of the
+// number of locations, the size of the payload and the payload itself. The payload contains the difference of each coordinate to
+// the previous location in the block as zigzag-encoded varint. Latitude and longitude are stored as FixedLocation units (1e-7
+// degrees) and the elevation in centimeters.
+#define TRACK_MAGIC "GCTRK\x01"
+#define TRACK_MAGIC_SIZE 6
+#define TRACK_FLAG_ELEVATION 0x1
+#define TRACK_BLOCK_SIZE 4096
+#define TRACK_ELEVATION_SCALE 1e2
+
+namespace {
+
+inline void appendVarInt(string &buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+inline void appendSignedVarInt(string &buffer, int64_t value)
+{
+    appendVarInt(buffer, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+inline uint64_t readVarInt(const unsigned char *&i, const unsigned char *end)
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; i != end && shift < 64; shift += 7) {
+        const unsigned char byte = *i++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw ParseError("Encoded track is truncated or corrupted.");
+}
+
+inline int64_t readSignedVarInt(const unsigned char *&i, const unsigned char *end)
+{
+    const uint64_t value = readVarInt(i, end);
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// adds the decoded difference to the previous value; corrupted input must not make it overflow
+inline void addDelta(int64_t &value, int64_t delta)
+{
+    if (delta > 0 ? value > numeric_limits<int64_t>::max() - delta : value < numeric_limits<int64_t>::min() - delta) {
+        throw ParseError("Encoded track is truncated or corrupted.");
+    }
+    value += delta;
+}
+
+uint64_t readVarInt(istream &stream)
+{
+    uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        const int byte = stream.get();
+        if (byte == char_traits<char>::eof()) {
+            throw ParseError("Encoded track is truncated or corrupted.");
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw ParseError("Encoded track is truncated or corrupted.");
+}
+
+} // namespace
+
+TrackEncoder::TrackEncoder(ostream &stream, bool withElevation)
+    : m_stream(stream)
+    , m_blockSize(0)
+    , m_previousLat(0)
+    , m_previousLon(0)
+    , m_previousEle(0)
+    , m_withElevation(withElevation)
+{
+    m_stream.write(TRACK_MAGIC, TRACK_MAGIC_SIZE);
+    m_stream.put(static_cast<char>(withElevation ? TRACK_FLAG_ELEVATION : 0));
+}
+
+void TrackEncoder::add(const Location &location)
+{
+    const FixedLocation fixedLocation(location);
+    const int64_t lat = fixedLocation.latitudeUnits();
+    const int64_t lon = fixedLocation.longitudeUnits();
+    appendSignedVarInt(m_block, lat - m_previousLat);
+    appendSignedVarInt(m_block, lon - m_previousLon);
+    m_previousLat = lat;
+    m_previousLon = lon;
+    if (m_withElevation) {
+        const auto ele = static_cast<int64_t>(llround(location.elevation() * TRACK_ELEVATION_SCALE));
+        appendSignedVarInt(m_block, ele - m_previousEle);
+        m_previousEle = ele;
+    }
+    if (++m_blockSize == TRACK_BLOCK_SIZE) {
+        flush();
+    }
+}
+
+void TrackEncoder::flush()
+{
+    if (!m_blockSize) {
+        return;
+    }
+    string header;
+    appendVarInt(header, m_blockSize);
+    appendVarInt(header, m_block.size());
+    m_stream.write(header.data(), static_cast<streamsize>(header.size()));
+    m_stream.write(m_block.data(), static_cast<streamsize>(m_block.size()));
+    m_block.clear();
+    m_blockSize = 0;
+    m_previousLat = m_previousLon = m_previousEle = 0;
+}
+
+TrackDecoder::TrackDecoder(istream &stream)
+    : m_stream(stream)
+    , m_withElevation(false)
+{
+    char header[TRACK_MAGIC_SIZE + 1];
+    if (!m_stream.read(header, sizeof(header)) || memcmp(header, TRACK_MAGIC, TRACK_MAGIC_SIZE)) {
+        throw ParseError("The file is no encoded track.");
+    }
+    m_withElevation = header[TRACK_MAGIC_SIZE] & TRACK_FLAG_ELEVATION;
+}
+
+bool TrackDecoder::decodeBlock(vector<Location> &locations)
+{
+    locations.clear();
+    if (m_stream.peek() == char_traits<char>::eof()) {
+        return false;
+    }
+    const auto count = readVarInt(m_stream);
+    const auto size = readVarInt(m_stream);
+    if (count > TRACK_BLOCK_SIZE || size > count * 30) {
+        throw ParseError("Encoded track is truncated or corrupted.");
+    }
+    m_block.resize(size);
+    if (!m_stream.read(&m_block[0], static_cast<streamsize>(size))) {
+        throw ParseError("Encoded track is truncated or corrupted.");
+    }
+
+    locations.reserve(count);
+    const auto *i = reinterpret_cast<const unsigned char *>(m_block.data()), *end = i + m_block.size();
+    int64_t lat = 0, lon = 0, ele = 0;
+    for (uint64_t index = 0; index != count; ++index) {
+        addDelta(lat, readSignedVarInt(i, end));
+        addDelta(lon, readSignedVarInt(i, end));
+        constexpr int64_t maxLat = 90ll * FixedLocation::unitsPerDegree, maxLon = 180ll * FixedLocation::unitsPerDegree;
+        if (lat < -maxLat || lat > maxLat || lon < -maxLon || lon > maxLon) {
+            throw ParseError("Encoded track is truncated or corrupted.");
+        }
+        locations.push_back(FixedLocation(static_cast<int32_t>(lat), static_cast<int32_t>(lon)).toLocation());
+        if (m_withElevation) {
+            addDelta(ele, readSignedVarInt(i, end));
+            locations.back().setElevation(static_cast<double>(ele) / TRACK_ELEVATION_SCALE);
+        }
+    }
+    return true;
+}
+
+bool isEncodedTrack(istream &stream)
+{
+    // look at the first byte before consuming anything; the stream might not be seekable (e.g. a pipe)
+    if (stream.peek() != TRACK_MAGIC[0]) {
+        stream.clear();
+        return false;
+    }
+    char magic[TRACK_MAGIC_SIZE];
+    const auto read = stream.read(magic, TRACK_MAGIC_SIZE).gcount();
+    const bool encoded = read == TRACK_MAGIC_SIZE && !memcmp(magic, TRACK_MAGIC, TRACK_MAGIC_SIZE);
+    // put back what has been read (text might start with the same character, e.g. an upper-case geohash); the characters are
+    // still in the buffer of the stream so this works even if the stream is not seekable
+    stream.clear();
+    for (auto i = read; i > 0; --i) {
+        if (stream.rdbuf()->sungetc() == char_traits<char>::eof()) {
+            throw ParseError("Unable to rewind the input after checking whether it is an encoded track.");
+        }
+    }
+    return encoded;
+}
+
+void forEachLocationFromEncodedTrack(istream &stream, const function<void(const Location &)> &callback)
+{
+    TrackDecoder decoder(stream);
+    vector<Location> locations;
+    while (decoder.decodeBlock(locations)) {
+        for (const Location &location : locations) {
+            callback(location);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TRACKCODEC_H
+#define TRACKCODEC_H
+
+#include "./location.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class TrackEncoder {
+public:
+    explicit TrackEncoder(std::ostream &stream, bool withElevation = false);
+
+    void add(const Location &location);
+    void flush();
+
+private:
+    std::ostream &m_stream;
+    std::string m_block;
+    std::size_t m_blockSize;
+    std::int64_t m_previousLat;
+    std::int64_t m_previousLon;
+    std::int64_t m_previousEle;
+    bool m_withElevation;
+};
+
+class TrackDecoder {
+public:
+    explicit TrackDecoder(std::istream &stream);
+
+    bool hasElevation() const;
+    bool decodeBlock(std::vector<Location> &locations);
+
+private:
+    std::istream &m_stream;
+    std::string m_block;
+    bool m_withElevation;
+};
+
+inline bool TrackDecoder::hasElevation() const
+{
+    return m_withElevation;
+}
+
+bool isEncodedTrack(std::istream &stream);
+void forEachLocationFromEncodedTrack(std::istream &stream, const std::function<void(const Location &)> &callback);
+
+#endif // TRACKCODEC_H
@@ -0,0 +1,61 @@
+#ifndef TRACKPOINT_H
+#define TRACKPOINT_H
+
+#include "./location.h"
+
+#include <cmath>
+
+class TrackPoint {
+public:
+    TrackPoint();
+    TrackPoint(const Location &location, double time = NAN);
+
+    const Location &location() const;
+    void setLocation(const Location &value);
+    double time() const;
+    void setTime(double value);
+    bool hasTime() const;
+
+private:
+    Location m_location;
+    // seconds since the Unix epoch; NaN if the track point has no timestamp
+    double m_time;
+};
+
+inline TrackPoint::TrackPoint()
+    : m_time(NAN)
+{
+}
+
+inline TrackPoint::TrackPoint(const Location &location, double time)
+    : m_location(location)
+    , m_time(time)
+{
+}
+
+inline const Location &TrackPoint::location() const
+{
+    return m_location;
+}
+
+inline void TrackPoint::setLocation(const Location &value)
+{
+    m_location = value;
+}
+
+inline double TrackPoint::time() const
+{
+    return m_time;
+}
+
+inline void TrackPoint::setTime(double value)
+{
+    m_time = value;
+}
+
+inline bool TrackPoint::hasTime() const
+{
+    return !std::isnan(m_time);
+}
+
+#endif // TRACKPOINT_H
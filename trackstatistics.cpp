@@ -0,0 +1,60 @@
+#include "./trackstatistics.h"
+
+using namespace std;
+
+TrackStatistics::TrackStatistics(double stopSpeed, double minStopDuration)
+    : m_stopSpeed(stopSpeed)
+    , m_minStopDuration(minStopDuration)
+    , m_pointCount(0)
+    , m_distance(0.0)
+    , m_timedDistance(0.0)
+    , m_duration(0.0)
+    , m_maxSpeed(0.0)
+    , m_stopped(false)
+    , m_currentStop{ Location(), 0.0, 0.0 }
+{
+}
+
+void TrackStatistics::add(const TrackPoint &point)
+{
+    if (m_pointCount++) {
+        const double distance = m_previous.location().distanceTo(point.location());
+        m_distance += distance;
+        // speed can only be determined between consecutive track points which both have a timestamp
+        const double timeDifference = point.time() - m_previous.time();
+        if (timeDifference > 0.0) {
+            const double speed = distance / timeDifference;
+            m_timedDistance += distance;
+            m_duration += timeDifference;
+            if (speed > m_maxSpeed) {
+                m_maxSpeed = speed;
+            }
+            if (speed < m_stopSpeed) {
+                if (!m_stopped) {
+                    m_stopped = true;
+                    m_currentStop.location = m_previous.location();
+                    m_currentStop.start = m_previous.time();
+                }
+                m_currentStop.end = point.time();
+            } else {
+                endStop();
+            }
+        }
+    }
+    m_previous = point;
+}
+
+void TrackStatistics::finish()
+{
+    endStop();
+}
+
+void TrackStatistics::endStop()
+{
+    if (m_stopped) {
+        m_stopped = false;
+        if (m_currentStop.end - m_currentStop.start >= m_minStopDuration) {
+            m_stops.push_back(m_currentStop);
+        }
+    }
+}
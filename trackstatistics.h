@@ -0,0 +1,74 @@
+#ifndef TRACKSTATISTICS_H
+#define TRACKSTATISTICS_H
+
+#include "./trackpoint.h"
+
+#include <cstddef>
+#include <vector>
+
+class TrackStatistics {
+public:
+    struct Stop {
+        Location location;
+        double start;
+        double end;
+    };
+
+    explicit TrackStatistics(double stopSpeed = 0.5, double minStopDuration = 60.0);
+
+    void add(const TrackPoint &point);
+    void finish();
+    std::size_t pointCount() const;
+    double distance() const;
+    double duration() const;
+    double averageSpeed() const;
+    double maxSpeed() const;
+    const std::vector<Stop> &stops() const;
+
+private:
+    void endStop();
+
+    double m_stopSpeed;
+    double m_minStopDuration;
+    std::size_t m_pointCount;
+    double m_distance;
+    double m_timedDistance;
+    double m_duration;
+    double m_maxSpeed;
+    TrackPoint m_previous;
+    bool m_stopped;
+    Stop m_currentStop;
+    std::vector<Stop> m_stops;
+};
+
+inline std::size_t TrackStatistics::pointCount() const
+{
+    return m_pointCount;
+}
+
+inline double TrackStatistics::distance() const
+{
+    return m_distance;
+}
+
+inline double TrackStatistics::duration() const
+{
+    return m_duration;
+}
+
+inline double TrackStatistics::averageSpeed() const
+{
+    return m_duration > 0.0 ? m_timedDistance / m_duration : 0.0;
+}
+
+inline double TrackStatistics::maxSpeed() const
+{
+    return m_maxSpeed;
+}
+
+inline const std::vector<TrackStatistics::Stop> &TrackStatistics::stops() const
+{
+    return m_stops;
+}
+
+#endif // TRACKSTATISTICS_H